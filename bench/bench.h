@@ -0,0 +1,25 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <r_util.h>
+
+// Timings are printed one per line as "<name> <n> <usec> <n/s>" so that
+// runs against two builds of r2 can be compared with a plain diff or sort.
+
+#define bench_start() ut64 _bench_t0 = r_sys_now ()
+
+#define bench_restart() _bench_t0 = r_sys_now ()
+
+#define bench_end(name, n) do { \
+		ut64 _bench_dt = r_sys_now () - _bench_t0; \
+		printf ("%-32s %10"PFMT64d" %10"PFMT64d"us %14.0f/s\n", \
+			(name), (ut64)(n), _bench_dt, \
+			_bench_dt? (double)(n) * 1000000.0 / _bench_dt: 0.0); \
+		fflush (stdout); \
+} while (0)
+
+static inline int bench_arg(int argc, char **argv, int def) {
+	return argc > 1? atoi (argv[1]): def;
+}
+
+#endif
@@ -0,0 +1,43 @@
+#include "bench.h"
+
+// Encodes and decodes a large random blob; n/s is bytes per second of the
+// binary side so encode and decode figures can be compared directly.
+
+int main(int argc, char **argv) {
+	int mb = bench_arg (argc, argv, 64);
+	int len = mb * 1024 * 1024;
+	int sizes[] = { 64, 4096, 65536, len };
+	ut8 *bin = malloc (len);
+	ut8 *dec = malloc (len);
+	char *enc = malloc (len / 3 * 4 + 8);
+	char name[64];
+	int i, j;
+
+	srand (1337);
+	for (i = 0; i < len; i++) {
+		bin[i] = rand ();
+	}
+	for (i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+		int sz = sizes[i];
+		// small sizes are repeated so that every run moves the same bytes
+		int reps = len / sz;
+		snprintf (name, sizeof (name), "base64.encode.%d", sz);
+		bench_start ();
+		for (j = 0; j < reps; j++) {
+			r_base64_encode (enc, bin + (ut64)j * sz % (len - sz + 1), sz);
+		}
+		bench_end (name, (ut64)reps * sz);
+
+		int enclen = r_base64_encode (enc, bin, sz);
+		snprintf (name, sizeof (name), "base64.decode.%d", sz);
+		bench_restart ();
+		for (j = 0; j < reps; j++) {
+			r_base64_decode (dec, enc, enclen);
+		}
+		bench_end (name, (ut64)reps * sz);
+	}
+	free (bin);
+	free (dec);
+	free (enc);
+	return 0;
+}
@@ -0,0 +1,51 @@
+#include "bench.h"
+
+static void big_random(RNumBig *n, int bits) {
+	RNumBig t, word;
+	int i;
+	r_big_set_st (n, 1);
+	r_big_set_st (&t, 1 << 16);
+	for (i = 16; i < bits; i += 16) {
+		r_big_mul (n, n, &t);
+		r_big_set_st (&word, rand () & 0xffff);
+		r_big_add (n, n, &word);
+	}
+}
+
+int main(int argc, char **argv) {
+	int iters = bench_arg (argc, argv, 1000);
+	int sizes[] = { 64, 128, 256, 512, 1024, 2048, 4096 };
+	RNumBig a, b, r;
+	char name[64];
+	int i, s;
+
+	srand (1);
+	for (s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++) {
+		big_random (&a, sizes[s]);
+		big_random (&b, sizes[s]);
+
+		snprintf (name, sizeof (name), "big.add.%d", sizes[s]);
+		bench_start ();
+		for (i = 0; i < iters; i++) {
+			r_big_add (&r, &a, &b);
+		}
+		bench_end (name, iters);
+
+		snprintf (name, sizeof (name), "big.mul.%d", sizes[s]);
+		bench_restart ();
+		for (i = 0; i < iters; i++) {
+			r_big_mul (&r, &a, &b);
+		}
+		bench_end (name, iters);
+
+		// 2n / n bits, the shape of a modular reduction
+		big_random (&a, sizes[s] * 2);
+		snprintf (name, sizeof (name), "big.div.%d", sizes[s]);
+		bench_restart ();
+		for (i = 0; i < iters; i++) {
+			r_big_div (&r, &a, &b);
+		}
+		bench_end (name, iters);
+	}
+	return 0;
+}
@@ -0,0 +1,42 @@
+#include "bench.h"
+
+#define SPAN (64 * 1024 * 1024)
+
+static void bench_writes(const char *name, int n, int stride) {
+	char label[64];
+	ut8 patch[8] = { 0x90, 0x90, 0x90, 0x90, 0xcc, 0xcc, 0xcc, 0xcc };
+	ut8 data[256];
+	RBuffer *b = r_buf_new_sparse ();
+	ut64 off = 0;
+	int i;
+
+	srand (31337);
+	snprintf (label, sizeof (label), "buf_sparse.%s.write", name);
+	bench_start ();
+	for (i = 0; i < n; i++) {
+		// stride 0 means random addresses, like patches all over an image
+		off = stride? off + stride: (ut64)(rand () % SPAN);
+		r_buf_write_at (b, 0x10000000 + off, patch, 1 + (i & 7));
+	}
+	bench_end (label, n);
+
+	snprintf (label, sizeof (label), "buf_sparse.%s.read", name);
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		r_buf_read_at (b, 0x10000000 + (rand () % SPAN), data, sizeof (data));
+	}
+	bench_end (label, n);
+
+	snprintf (label, sizeof (label), "buf_sparse.%s.free", name);
+	bench_restart ();
+	r_buf_free (b);
+	bench_end (label, n);
+}
+
+int main(int argc, char **argv) {
+	int n = bench_arg (argc, argv, 1000000);
+	bench_writes ("adjacent", n, 4);
+	bench_writes ("gapped", n, 16);
+	bench_writes ("random", n, 0);
+	return 0;
+}
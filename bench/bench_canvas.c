@@ -0,0 +1,70 @@
+#include "bench.h"
+#include <r_cons.h>
+
+// One frame per keypress in visual graph mode: clear the canvas, draw
+// every node and edge, then turn it into terminal output. Reports the
+// time per frame and the bytes a frame writes with full and damage output.
+
+#define COLS 12
+#define ROWS 6
+
+typedef struct {
+	int x, y;
+} Node;
+
+static void draw(RConsCanvas *can, Node *nodes, int n) {
+	RCanvasLineStyle style = { 0 };
+	char title[32];
+	int i;
+	r_cons_canvas_clear (can);
+	for (i = 0; i + COLS < n; i++) {
+		r_cons_canvas_line (can, nodes[i].x + 4, nodes[i].y + 6,
+			nodes[i + COLS].x + 4, nodes[i + COLS].y, &style);
+	}
+	for (i = 0; i < n; i++) {
+		snprintf (title, sizeof (title), "0x%08x", 0x8048000 + i * 0x20);
+		r_cons_canvas_gotoxy (can, nodes[i].x + 1, nodes[i].y + 1);
+		r_cons_canvas_write (can, title);
+		r_cons_canvas_gotoxy (can, nodes[i].x + 2, nodes[i].y + 2);
+		r_cons_canvas_write (can, "push ebp\nmov ebp, esp\nret");
+		r_cons_canvas_box (can, nodes[i].x, nodes[i].y, 14, 6, NULL);
+	}
+}
+
+static void run(const char *name, int frames, bool damage) {
+	RConsCanvas *can = r_cons_canvas_new (COLS * 16, ROWS * 10);
+	Node nodes[COLS * ROWS];
+	char bname[64];
+	ut64 bytes = 0;
+	int i;
+	for (i = 0; i < COLS * ROWS; i++) {
+		nodes[i].x = (i % COLS) * 16;
+		nodes[i].y = (i / COLS) * 10;
+	}
+	bench_start ();
+	for (i = 0; i < frames; i++) {
+		// a keypress moves the selected node by one cell
+		Node *n = &nodes[(i / 16) % (COLS * ROWS)];
+		n->x += (i & 1)? 1: -1;
+		n->y += (i & 2)? 1: -1;
+		draw (can, nodes, COLS * ROWS);
+		char *out = damage
+			? r_cons_canvas_to_string_damage (can)
+			: r_cons_canvas_to_string (can);
+		bytes += strlen (out);
+		free (out);
+	}
+	bench_end (name, frames);
+	snprintf (bname, sizeof (bname), "%s.bytes", name);
+	printf ("%-32s %10"PFMT64d" %10"PFMT64d"B/frame\n", bname, (ut64)frames, bytes / frames);
+	r_cons_canvas_free (can);
+}
+
+int main(int argc, char **argv) {
+	int frames = bench_arg (argc, argv, 2000);
+	r_cons_new ();
+	run ("canvas.frame.full", frames, false);
+	run ("canvas.frame.damage", frames, true);
+	r_cons_free ();
+	return 0;
+}
@@ -0,0 +1,64 @@
+#include "bench.h"
+#include <r_config.h>
+
+// Per instruction the disassembler reads a handful of asm.* and scr.*
+// variables; compare resolving them by name with cached handles.
+
+static const char *prefixes[] = { "asm", "anal", "scr", "io", "bin", "dbg", "cfg", "search" };
+static const char *hot[] = { "asm.bytes", "asm.lines", "asm.comments", "asm.bits", "scr.color", "scr.utf8", "anal.depth", "asm.offset" };
+#define NHOT (sizeof (hot) / sizeof (hot[0]))
+
+int main(int argc, char **argv) {
+	int n = bench_arg (argc, argv, 10000000);
+	RConfig *cfg = r_config_new (NULL);
+	RConfigHandle *handles[NHOT];
+	char name[64];
+	ut64 sum = 0, hsum = 0;
+	int i, j;
+
+	// about as many variables as a running r2 has
+	for (i = 0; i < sizeof (prefixes) / sizeof (prefixes[0]); i++) {
+		for (j = 0; j < 80; j++) {
+			snprintf (name, sizeof (name), "%s.var%d", prefixes[i], j);
+			r_config_set_i (cfg, name, j);
+		}
+	}
+	for (i = 0; i < NHOT; i++) {
+		r_config_set_i (cfg, hot[i], i);
+		handles[i] = r_config_handle_new (cfg, hot[i]);
+	}
+
+	bench_start ();
+	for (i = 0; i < n; i++) {
+		sum += r_config_get_i (cfg, hot[i % NHOT]);
+	}
+	bench_end ("config.get_i.name", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		hsum += r_config_handle_get_i (handles[i % NHOT]);
+	}
+	bench_end ("config.get_i.handle", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		hsum += r_config_handle_get_b (handles[i % NHOT]);
+	}
+	bench_end ("config.get_b.handle", n);
+
+	// a setter in the loop, as when a command changes a variable per line
+	bench_restart ();
+	for (i = 0; i < n / 10; i++) {
+		r_config_set_i (cfg, "asm.bits", 16 << (i & 1));
+		hsum += r_config_handle_get_i (handles[3]);
+	}
+	bench_end ("config.set_i+get_i.handle", n / 10);
+	if (!sum || !hsum) {
+		eprintf ("unexpected zero sums\n");
+	}
+	for (i = 0; i < NHOT; i++) {
+		r_config_handle_free (handles[i]);
+	}
+	r_config_free (cfg);
+	return 0;
+}
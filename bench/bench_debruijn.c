@@ -0,0 +1,40 @@
+#include "bench.h"
+
+#define DEBRUIJN_MAX (62 * 62 * 62)
+
+// Looks up offsets spread over the whole pattern, the cost of a lookup
+// must not grow with the offset being searched.
+
+int main(int argc, char **argv) {
+	int n = bench_arg (argc, argv, 100000);
+	int sizes[] = { 0x100, 0x1000, 0x10000, DEBRUIJN_MAX };
+	char name[64];
+	int i, j, found;
+
+	for (i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+		snprintf (name, sizeof (name), "debruijn.pattern.%d", sizes[i]);
+		bench_start ();
+		char *pattern = r_debruijn_pattern (sizes[i], 0, NULL);
+		bench_end (name, sizes[i]);
+
+		ut32 *values = malloc (n * sizeof (ut32));
+		srand (1337);
+		for (j = 0; j < n; j++) {
+			values[j] = r_read_le32 (pattern + rand () % (sizes[i] - 4));
+		}
+		found = 0;
+		snprintf (name, sizeof (name), "debruijn.offset.%d", sizes[i]);
+		bench_restart ();
+		for (j = 0; j < n; j++) {
+			found += r_debruijn_offset (values[j], false) >= 0;
+		}
+		bench_end (name, n);
+		if (found != n) {
+			eprintf ("%d of %d offsets not found\n", n - found, n);
+			return 1;
+		}
+		free (values);
+		free (pattern);
+	}
+	return 0;
+}
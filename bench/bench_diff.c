@@ -0,0 +1,48 @@
+#include "bench.h"
+#include <r_diff.h>
+
+static void run(const char *kind, int size, const ut8 *a, const ut8 *b) {
+	RDiff *d = r_diff_new ();
+	char name[64];
+	ut32 dist = 0;
+
+	d->levenstein = true;
+	snprintf (name, sizeof (name), "diff.%s.%dk.full", kind, size / 1024);
+	bench_start ();
+	r_diff_buffers_distance (d, a, size, b, size, &dist, NULL);
+	bench_end (name, size);
+
+	snprintf (name, sizeof (name), "diff.%s.%dk.cutoff", kind, size / 1024);
+	bench_restart ();
+	r_diff_buffers_distance_cutoff (d, a, size, b, size, size / 100, &dist);
+	bench_end (name, size);
+	r_diff_free (d);
+}
+
+int main(int argc, char **argv) {
+	int max = bench_arg (argc, argv, 1024) * 1024;
+	ut8 *a = malloc (max), *b = malloc (max), *c = malloc (max);
+	int i, size;
+
+	if (!a || !b || !c) {
+		return 1;
+	}
+	srand (1);
+	for (i = 0; i < max; i++) {
+		a[i] = rand ();
+		c[i] = rand ();
+	}
+	// b differs from a in about 1% of the bytes, like two builds of a function
+	memcpy (b, a, max);
+	for (i = 0; i < max / 100; i++) {
+		b[rand () % max] ^= 0x55;
+	}
+	for (size = 1024; size <= max; size *= 4) {
+		run ("similar", size, a, b);
+		run ("unrelated", size, a, c);
+	}
+	free (a);
+	free (b);
+	free (c);
+	return 0;
+}
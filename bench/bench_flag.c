@@ -0,0 +1,85 @@
+#include "bench.h"
+#include <r_cons.h>
+#include <r_flags.h>
+
+// set/get/closest/list/delete with as many flags as a large binary has
+// symbols, inserted in random order
+
+static int rnd(int n) {
+	return (int)((((ut32)rand () << 16) ^ (ut32)rand ()) % n);
+}
+
+int main(int argc, char **argv) {
+	int n = bench_arg (argc, argv, 2000000);
+	char *namebuf = malloc ((size_t)n * 16);
+	const char **names = malloc (n * sizeof (char *));
+	ut64 *addrs = malloc (n * sizeof (ut64));
+	ut32 *sizes = malloc (n * sizeof (ut32));
+	int i, found = 0;
+	char name[32];
+
+	srand (1337);
+	// the first flag is at the lowest address so closest lookups always hit
+	for (i = 0; i < n; i++) {
+		int k = i? rnd (n): 0;
+		names[i] = namebuf + (size_t)i * 16;
+		snprintf (namebuf + (size_t)i * 16, 16, "sym.%d", i);
+		addrs[i] = 0x400000 + (ut64)k * 16;
+		sizes[i] = 16;
+	}
+
+	RFlag *flags = r_flag_new ();
+	bench_start ();
+	for (i = 0; i < n; i++) {
+		r_flag_set (flags, names[i], addrs[i], sizes[i]);
+	}
+	bench_end ("flag.set", n);
+	r_flag_free (flags);
+
+	flags = r_flag_new ();
+	bench_restart ();
+	r_flag_set_many (flags, names, addrs, sizes, n);
+	bench_end ("flag.set_many", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		snprintf (name, sizeof (name), "sym.%d", rnd (n));
+		found += r_flag_get (flags, name) != NULL;
+	}
+	bench_end ("flag.get", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		found += r_flag_get_i (flags, addrs[rnd (n)]) != NULL;
+	}
+	bench_end ("flag.get_i", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		found += r_flag_get_at (flags, 0x400000 + (ut64)rnd (n * 16), true) != NULL;
+	}
+	bench_end ("flag.get_at.closest", n);
+
+	// the listing goes to the cons buffer, which is dropped instead of printed
+	r_cons_new ();
+	bench_restart ();
+	r_flag_list (flags, 0, NULL);
+	bench_end ("flag.list", n);
+	r_cons_reset ();
+	r_cons_free ();
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		r_flag_unset_name (flags, names[i]);
+	}
+	bench_end ("flag.unset_name", n);
+	if (found != n * 3) {
+		eprintf ("%d lookups found nothing\n", n * 3 - found);
+	}
+	r_flag_free (flags);
+	free (namebuf);
+	free (names);
+	free (addrs);
+	free (sizes);
+	return 0;
+}
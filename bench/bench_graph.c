@@ -0,0 +1,80 @@
+#include "bench.h"
+
+// call graph shaped input: every node calls a few random later nodes
+// plus some back edges for recursion
+static RGraph *generate(int n, RGraphNode **nodes) {
+	RGraph *g = r_graph_new ();
+	int i, j;
+	for (i = 0; i < n; i++) {
+		nodes[i] = r_graph_add_node (g, (void *)(intptr_t)i);
+	}
+	for (i = 0; i < n - 1; i++) {
+		r_graph_add_edge (g, nodes[i], nodes[i + 1 + rand () % R_MIN (64, n - i - 1)]);
+		for (j = 0; j < 3; j++) {
+			r_graph_add_edge (g, nodes[i], nodes[rand () % n]);
+		}
+	}
+	return g;
+}
+
+static void count_node(RGraphNode *n, RGraphVisitor *vis) {
+	vis->data = (void *)((intptr_t)vis->data + 1);
+}
+
+int main(int argc, char **argv) {
+	int max = bench_arg (argc, argv, 1000000);
+	char name[64];
+	int n;
+
+	srand (1);
+	for (n = 10000; n <= max; n *= 10) {
+		RGraphNode **nodes = malloc (sizeof (RGraphNode *) * n);
+		int *out = malloc (sizeof (int) * n);
+		int *aux = malloc (sizeof (int) * n);
+		RGraph *g = generate (n, nodes);
+		RGraphVisitor vis = { 0 };
+
+		vis.discover_node = (RGraphNodeCallback)count_node;
+		snprintf (name, sizeof (name), "graph.rlist.dfs.%d", n);
+		bench_start ();
+		r_graph_dfs_node (g, nodes[0], &vis);
+		bench_end (name, (intptr_t)vis.data);
+
+		snprintf (name, sizeof (name), "graph.csr.snapshot.%d", n);
+		bench_restart ();
+		RGraphCSR *csr = r_graph_csr_new (g);
+		bench_end (name, n);
+
+		snprintf (name, sizeof (name), "graph.csr.dfs.%d", n);
+		bench_restart ();
+		int reached = r_graph_csr_dfs (csr, 0, out);
+		bench_end (name, reached);
+
+		snprintf (name, sizeof (name), "graph.csr.bfs.%d", n);
+		bench_restart ();
+		reached = r_graph_csr_bfs (csr, 0, out);
+		bench_end (name, reached);
+
+		snprintf (name, sizeof (name), "graph.csr.topo.%d", n);
+		bench_restart ();
+		r_graph_csr_topo (csr, out);
+		bench_end (name, n);
+
+		snprintf (name, sizeof (name), "graph.csr.dominators.%d", n);
+		bench_restart ();
+		r_graph_csr_dominators (csr, 0, aux);
+		bench_end (name, n);
+
+		snprintf (name, sizeof (name), "graph.csr.scc.%d", n);
+		bench_restart ();
+		r_graph_csr_scc (csr, aux);
+		bench_end (name, n);
+
+		r_graph_csr_free (csr);
+		r_graph_free (g);
+		free (nodes);
+		free (out);
+		free (aux);
+	}
+	return 0;
+}
@@ -0,0 +1,59 @@
+#include "bench.h"
+#include <r_core.h>
+#include <sys/resource.h>
+
+// Lays out synthetic control flow graphs of 100..20k blocks with agg and
+// records the time and the peak resident memory after each size. Blocks
+// form nested if/else diamonds with loop back edges, like a big function.
+
+static void build_cfg(RCore *core, int n) {
+	int i;
+	r_core_cmd0 (core, "ag-");
+	for (i = 0; i < n; i++) {
+		r_core_cmdf (core, "agn bb.%d \"cmp eax, %d\"", i, i);
+	}
+	for (i = 0; i + 1 < n; i++) {
+		r_core_cmdf (core, "age bb.%d bb.%d", i, i + 1);
+		switch (rand () % 4) {
+		case 0: // forward branch over a few blocks
+			r_core_cmdf (core, "age bb.%d bb.%d", i, R_MIN (n - 1, i + 2 + rand () % 8));
+			break;
+		case 1: // loop back edge
+			if (i > 4) {
+				r_core_cmdf (core, "age bb.%d bb.%d", i, i - 1 - rand () % 4);
+			}
+			break;
+		}
+	}
+}
+
+static long maxrss_kb(void) {
+	struct rusage ru;
+	getrusage (RUSAGE_SELF, &ru);
+	return ru.ru_maxrss;
+}
+
+int main(int argc, char **argv) {
+	int sizes[] = { 100, 500, 1000, 2000, 5000, 10000, 20000 };
+	int max = bench_arg (argc, argv, 20000);
+	RCore *core = r_core_new ();
+	char name[64];
+	int i;
+
+	r_core_cmd0 (core, "e scr.color=0");
+	r_core_cmd0 (core, "e scr.interactive=false");
+	for (i = 0; i < sizeof (sizes) / sizeof (sizes[0]) && sizes[i] <= max; i++) {
+		srand (1337);
+		build_cfg (core, sizes[i]);
+		snprintf (name, sizeof (name), "graph.layout.%d", sizes[i]);
+		bench_start ();
+		char *out = r_core_cmd_str (core, "agg");
+		bench_end (name, sizes[i]);
+		snprintf (name, sizeof (name), "graph.layout.%d.maxrss", sizes[i]);
+		printf ("%-32s %10d %10ldKB\n", name, sizes[i], maxrss_kb ());
+		fflush (stdout);
+		free (out);
+	}
+	r_core_free (core);
+	return 0;
+}
@@ -0,0 +1,55 @@
+#include "bench.h"
+#include <r_hash.h>
+
+#define ALGOS (R_HASH_MD5 | R_HASH_SHA1 | R_HASH_SHA256)
+#define CHUNK (4 * 1024 * 1024)
+
+// one pass per algorithm over the whole input, like separate rahash2 runs
+static void bench_separate(const ut8 *buf, ut64 size) {
+	ut64 algo, off;
+	bench_start ();
+	for (algo = 1; algo <= ALGOS; algo <<= 1) {
+		if (!(algo & ALGOS)) {
+			continue;
+		}
+		RHash *h = r_hash_new (false, algo);
+		r_hash_do_begin (h, algo);
+		for (off = 0; off < size; off += CHUNK) {
+			r_hash_calculate (h, algo, buf + off, (int)R_MIN (CHUNK, size - off));
+		}
+		r_hash_do_end (h, algo);
+		r_hash_free (h);
+	}
+	bench_end ("hash.md5+sha1+sha256.separate.bytes", size);
+}
+
+static void bench_stream(const ut8 *buf, ut64 size, int threads) {
+	char name[64];
+	ut64 off;
+	RHashStream *hs = r_hash_stream_new (ALGOS, threads);
+	snprintf (name, sizeof (name), "hash.md5+sha1+sha256.stream%d.bytes", threads);
+	bench_start ();
+	for (off = 0; off < size; off += CHUNK) {
+		r_hash_stream_update (hs, buf + off, R_MIN (CHUNK, size - off));
+	}
+	r_hash_stream_end (hs);
+	bench_end (name, size);
+	r_hash_stream_free (hs);
+}
+
+int main(int argc, char **argv) {
+	ut64 size = (ut64)bench_arg (argc, argv, 1024) * 1024 * 1024;
+	ut8 *buf = malloc (size);
+	ut64 i;
+	if (!buf) {
+		return 1;
+	}
+	for (i = 0; i < size; i++) {
+		buf[i] = i ^ (i >> 13);
+	}
+	bench_separate (buf, size);
+	bench_stream (buf, size, 0);
+	bench_stream (buf, size, 3);
+	free (buf);
+	return 0;
+}
@@ -0,0 +1,67 @@
+#include "bench.h"
+
+#define ROUNDS 10
+
+// allocate n small objects, then drop them all, like per-function analysis
+static void bench_malloc(int n, void **ptrs) {
+	int r, i;
+	bench_start ();
+	for (r = 0; r < ROUNDS; r++) {
+		for (i = 0; i < n; i++) {
+			ptrs[i] = malloc (48);
+		}
+		for (i = 0; i < n; i++) {
+			free (ptrs[i]);
+		}
+	}
+	bench_end ("mem.malloc", (ut64)n * ROUNDS);
+}
+
+static void bench_pool(int n) {
+	int r, i;
+	bench_start ();
+	for (r = 0; r < ROUNDS; r++) {
+		RMemoryPool *pool = r_mem_pool_new (48, 4096, 0);
+		for (i = 0; i < n; i++) {
+			r_mem_pool_alloc (pool);
+		}
+		r_mem_pool_free (pool);
+	}
+	bench_end ("mem.pool", (ut64)n * ROUNDS);
+}
+
+static void bench_arena(int n) {
+	RMemArena *a = r_mem_arena_new (0);
+	int r, i;
+	bench_start ();
+	for (r = 0; r < ROUNDS; r++) {
+		for (i = 0; i < n; i++) {
+			r_mem_arena_alloc (a, 48);
+		}
+		r_mem_arena_reset (a);
+	}
+	bench_end ("mem.arena", (ut64)n * ROUNDS);
+	r_mem_arena_free (a);
+
+	bench_restart ();
+	for (r = 0; r < ROUNDS; r++) {
+		for (i = 0; i < n; i++) {
+			r_mem_arena_alloc (r_mem_arena_thread (), 48);
+		}
+		r_mem_arena_reset (r_mem_arena_thread ());
+	}
+	bench_end ("mem.arena.thread", (ut64)n * ROUNDS);
+}
+
+int main(int argc, char **argv) {
+	int n = bench_arg (argc, argv, 1000000);
+	void **ptrs = malloc (sizeof (void *) * n);
+	if (!ptrs) {
+		return 1;
+	}
+	bench_malloc (n, ptrs);
+	bench_pool (n);
+	bench_arena (n);
+	free (ptrs);
+	return 0;
+}
@@ -0,0 +1,77 @@
+#include "bench.h"
+#include <r_parse.h>
+
+// asm.pseudo translates every line of pdf; compare translating one
+// instruction at a time with translating a function worth at once.
+
+#define FUNC_SIZE 4096
+
+static const char *x86[] = {
+	"push rbp", "mov rbp, rsp", "sub rsp, 0x20", "mov dword [rbp - 4], edi",
+	"mov eax, dword [rbp - 4]", "add eax, 1", "cmp eax, 0x10", "jle 0x400540",
+	"lea rdi, [rip + 0x200]", "call 0x400410", "xor eax, eax", "leave", "ret", NULL
+};
+static const char *mips[] = {
+	"addiu sp, sp, -0x20", "sw ra, 0x1c(sp)", "sw fp, 0x18(sp)", "move fp, sp",
+	"lui v0, 0x40", "addiu a0, v0, 0x7a0", "jal 0x400600", "nop",
+	"move sp, fp", "lw ra, 0x1c(sp)", "jr ra", NULL
+};
+static const char *arm[] = {
+	"push {r11, lr}", "add r11, sp, 4", "sub sp, sp, 8", "str r0, [r11, -8]",
+	"ldr r3, [r11, -8]", "add r3, r3, 1", "cmp r3, 0x10", "ble 0x8400",
+	"bl 0x8300", "mov r0, r3", "pop {r11, pc}", NULL
+};
+
+static const struct {
+	const char *plugin;
+	const char **ops;
+} sets[] = {
+	{ "x86.pseudo", x86 },
+	{ "mips.pseudo", mips },
+	{ "arm.pseudo", arm },
+};
+
+int main(int argc, char **argv) {
+	int n = bench_arg (argc, argv, 2000000);
+	const char *func[FUNC_SIZE];
+	char *out[FUNC_SIZE];
+	char str[1024], name[64];
+	RParse *p = r_parse_new ();
+	int i, j, s, total = 0;
+
+	n = R_MAX (FUNC_SIZE, n / FUNC_SIZE * FUNC_SIZE);
+	for (s = 0; s < sizeof (sets) / sizeof (sets[0]); s++) {
+		int nops = 0;
+		while (sets[s].ops[nops]) {
+			nops++;
+		}
+		for (i = 0; i < FUNC_SIZE; i++) {
+			func[i] = sets[s].ops[i % nops];
+		}
+		r_parse_use (p, sets[s].plugin);
+
+		// pd keeps a copy of every translated line, as the batch does
+		bench_start ();
+		for (i = 0; i < n; i++) {
+			total += r_parse_parse (p, func[i % FUNC_SIZE], str);
+			free (strdup (str));
+		}
+		snprintf (name, sizeof (name), "parse.%s", sets[s].plugin);
+		bench_end (name, n);
+
+		bench_restart ();
+		for (i = 0; i < n; i += FUNC_SIZE) {
+			total += r_parse_parse_batch (p, func, out, FUNC_SIZE);
+			for (j = 0; j < FUNC_SIZE; j++) {
+				free (out[j]);
+			}
+		}
+		snprintf (name, sizeof (name), "parse_batch.%s", sets[s].plugin);
+		bench_end (name, n);
+	}
+	if (!total) {
+		eprintf ("nothing was translated\n");
+	}
+	r_parse_free (p);
+	return 0;
+}
@@ -0,0 +1,100 @@
+#include "bench.h"
+#include <r_th.h>
+
+#define MAX_THREADS 32
+
+typedef struct {
+	RMpmcQueue *mpmc;
+	RQueue *rq;
+	RThreadLock *lock;
+	int items; // per producer
+	int total;
+	int consumed;
+} QueueCtx;
+
+static int mpmc_producer(RThread *th) {
+	QueueCtx *ctx = th->user;
+	int i;
+	for (i = 0; i < ctx->items; i++) {
+		while (!r_mpmc_queue_push (ctx->mpmc, (void *)(intptr_t)(i + 1))) {
+			;
+		}
+	}
+	return 0;
+}
+
+static int mpmc_consumer(RThread *th) {
+	QueueCtx *ctx = th->user;
+	void *item;
+	while (ctx->consumed < ctx->total) {
+		if (r_mpmc_queue_pop (ctx->mpmc, &item)) {
+			__sync_fetch_and_add (&ctx->consumed, 1);
+		}
+	}
+	return 0;
+}
+
+static int locked_producer(RThread *th) {
+	QueueCtx *ctx = th->user;
+	int i;
+	for (i = 0; i < ctx->items; i++) {
+		r_th_lock_enter (ctx->lock);
+		r_queue_enqueue (ctx->rq, (void *)(intptr_t)(i + 1));
+		r_th_lock_leave (ctx->lock);
+	}
+	return 0;
+}
+
+static int locked_consumer(RThread *th) {
+	QueueCtx *ctx = th->user;
+	void *item;
+	while (ctx->consumed < ctx->total) {
+		r_th_lock_enter (ctx->lock);
+		item = r_queue_dequeue (ctx->rq);
+		r_th_lock_leave (ctx->lock);
+		if (item) {
+			__sync_fetch_and_add (&ctx->consumed, 1);
+		}
+	}
+	return 0;
+}
+
+static void run(const char *name, QueueCtx *ctx, int n, RThreadFunction prod, RThreadFunction cons) {
+	RThread *th[MAX_THREADS * 2];
+	int i;
+	ctx->consumed = 0;
+	ctx->total = ctx->items * n;
+	bench_start ();
+	for (i = 0; i < n; i++) {
+		th[i] = r_th_new (prod, ctx, 0);
+		th[n + i] = r_th_new (cons, ctx, 0);
+	}
+	for (i = 0; i < n * 2; i++) {
+		r_th_wait (th[i]);
+		r_th_free (th[i]);
+	}
+	bench_end (name, ctx->total);
+}
+
+int main(int argc, char **argv) {
+	QueueCtx ctx = { 0 };
+	char name[64];
+	int total = bench_arg (argc, argv, 1000000);
+	int n;
+
+	ctx.mpmc = r_mpmc_queue_new (1024);
+	ctx.rq = r_queue_new (1024);
+	ctx.lock = r_th_lock_new (false);
+	// the same number of items is moved for every producer/consumer count
+	for (n = 1; n <= MAX_THREADS; n *= 2) {
+		ctx.items = total / n;
+		snprintf (name, sizeof (name), "queue.mpmc.%dx%d", n, n);
+		run (name, &ctx, n, mpmc_producer, mpmc_consumer);
+		snprintf (name, sizeof (name), "queue.locked.%dx%d", n, n);
+		run (name, &ctx, n, locked_producer, locked_consumer);
+	}
+	r_th_lock_free (ctx.lock);
+	r_queue_free (ctx.rq);
+	r_mpmc_queue_free (ctx.mpmc);
+	return 0;
+}
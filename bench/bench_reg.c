@@ -0,0 +1,81 @@
+#include "bench.h"
+#include <r_reg.h>
+
+// One traced step: snapshot the registers, change a few of them and find
+// out which ones changed. Timed per step with a copy of the arena and a per
+// register compare, then with the snapshot ring and the arena diff.
+
+static const char *regs[] = { "eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi", "eip", "eflags" };
+
+static RReg *new_reg(void) {
+	RReg *reg = r_reg_new ();
+	// the x86-32 profile with the st and xmm registers of legacy_unit/reg/regdiff.c
+	r_reg_set_profile_string (reg,
+		"gpr eax .32 0 0\ngpr ecx .32 4 0\ngpr edx .32 8 0\ngpr ebx .32 12 0\n"
+		"gpr esp .32 16 0\ngpr ebp .32 20 0\ngpr esi .32 24 0\ngpr edi .32 28 0\n"
+		"gpr eip .32 32 0\ngpr eflags .32 36 0\n"
+		"gpr st0 .80 64 0\ngpr st1 .80 74 0\ngpr st2 .80 84 0\ngpr st3 .80 94 0\n"
+		"gpr st4 .80 104 0\ngpr st5 .80 114 0\ngpr st6 .80 124 0\ngpr st7 .80 134 0\n"
+		"gpr xmm0 .128 176 0\ngpr xmm1 .128 192 0\ngpr xmm2 .128 208 0\ngpr xmm3 .128 224 0\n"
+		"gpr xmm4 .128 240 0\ngpr xmm5 .128 256 0\ngpr xmm6 .128 272 0\ngpr xmm7 .128 288 0\n"
+		"gpr mxcsr .32 304 0\n");
+	return reg;
+}
+
+static void step(RReg *reg, int i) {
+	r_reg_setv (reg, "eip", 0x8048000 + i);
+	r_reg_setv (reg, regs[i % 8], i);
+}
+
+int main(int argc, char **argv) {
+	int n = bench_arg (argc, argv, 1000000);
+	int i, sz;
+	RReg *reg = new_reg ();
+	RRegArena *arena = reg->regset[R_REG_TYPE_GPR].arena;
+	ut8 *snap = NULL;
+
+	bench_start ();
+	for (i = 0; i < n; i++) {
+		RListIter *iter;
+		RRegItem *ri;
+		free (snap);
+		snap = r_reg_get_bytes (reg, R_REG_TYPE_GPR, &sz);
+		step (reg, i);
+		RList *diff = r_list_new ();
+		r_list_foreach (reg->regset[R_REG_TYPE_GPR].regs, iter, ri) {
+			int off = ri->offset / 8;
+			if (memcmp (arena->bytes + off, snap + off, (ri->size + 7) / 8)) {
+				r_list_append (diff, ri);
+			}
+		}
+		r_list_free (diff);
+	}
+	bench_end ("reg.step.copy", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		r_reg_set_bytes (reg, R_REG_TYPE_GPR, snap, sz);
+	}
+	bench_end ("reg.restore.copy", n);
+	free (snap);
+
+	r_reg_arena_ring (reg, 64);
+	int last = r_reg_arena_save (reg);
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		step (reg, i);
+		RList *diff = r_reg_arena_diff (reg, R_REG_TYPE_GPR,
+			r_reg_arena_saved (reg, R_REG_TYPE_GPR, last), arena->size);
+		r_list_free (diff);
+		last = r_reg_arena_save (reg);
+	}
+	bench_end ("reg.step.ring", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		r_reg_arena_load (reg, last);
+	}
+	bench_end ("reg.restore.ring", n);
+	r_reg_free (reg);
+	return 0;
+}
@@ -0,0 +1,153 @@
+#include "bench.h"
+#include <r_search.h>
+
+// Searches 1..10k keywords over real executables of several archs from
+// bins, once with the byte by byte scanner and once with the automaton,
+// then times regexp mode with and without literals for the prefilter.
+
+static const char *corpus_files[] = {
+	"../bins/elf/analysis/pid_stripped",
+	"../bins/elf/analysis/go_stripped",
+	"../bins/elf/analysis/busybox.m68k",
+	"../bins/elf/analysis/mipsbe-busybox",
+	"../bins/elf/analysis/busybox-mips",
+	"../bins/pe/cmd_adf_sample0.exe",
+	NULL
+};
+
+static int count_hit(RSearchKeyword *kw, void *user, ut64 addr) {
+	(*(int *)user)++;
+	return 1;
+}
+
+// rand () may only give 15 bits, the corpus is larger than that
+static int rnd(int n) {
+	return (int)((((ut32)rand () << 16) ^ (ut32)rand ()) % n);
+}
+
+static int distinct_bytes(const ut8 *b, int len) {
+	bool seen[256] = { 0 };
+	int i, n = 0;
+	for (i = 0; i < len; i++) {
+		if (!seen[b[i]]) {
+			seen[b[i]] = true;
+			n++;
+		}
+	}
+	return n;
+}
+
+static ut8 *load_corpus(int *len) {
+	ut8 *buf = NULL;
+	int i, total = 0;
+	for (i = 0; corpus_files[i]; i++) {
+		int sz = 0;
+		char *data = r_file_slurp (corpus_files[i], &sz);
+		if (!data) {
+			eprintf ("Cannot open %s\n", corpus_files[i]);
+			continue;
+		}
+		buf = realloc (buf, total + sz);
+		memcpy (buf + total, data, sz);
+		total += sz;
+		free (data);
+	}
+	*len = total;
+	return buf;
+}
+
+static int run(const char *name, int engine, const ut8 *buf, int len, const ut8 **kws, const int *kwlens, int n) {
+	RSearch *rs = r_search_new (R_SEARCH_KEYWORD);
+	int i, hits = 0;
+	r_search_set_engine (rs, engine);
+	for (i = 0; i < n; i++) {
+		r_search_kw_add (rs, r_search_keyword_new (kws[i], kwlens[i], NULL, 0, NULL));
+	}
+	r_search_set_callback (rs, count_hit, &hits);
+	bench_start ();
+	r_search_begin (rs);
+	// feed the corpus the way r_core_search does, one block at a time
+	for (i = 0; i < len; i += 0x10000) {
+		r_search_update_i (rs, i, buf + i, R_MIN (0x10000, len - i));
+	}
+	bench_end (name, len);
+	r_search_free (rs);
+	return hits;
+}
+
+// strings, paths and prologues that do occur in the corpus, with and
+// without a literal for the prefilter to look for
+static const char *regexps[] = {
+	"GLIBC_[0-9.]+",
+	"lib[a-z]+[.]so",
+	"[a-z_]+printf",
+	"/(usr|bin|etc)/[a-z]+",
+	"Usage: [a-z]+",
+	"[A-Za-z]{12,}",
+	"[0-9]{4,}",
+	"\x55\x89\xe5|\x48\x89\xe5",
+	NULL
+};
+
+static void run_regexp(const char *pattern, const ut8 *buf, int len) {
+	RSearch *rs = r_search_new (R_SEARCH_REGEXP);
+	char name[64];
+	int i, hits = 0;
+	r_search_kw_add (rs, r_search_keyword_new_str (pattern, "", NULL, 0));
+	r_search_set_callback (rs, count_hit, &hits);
+	snprintf (name, sizeof (name), "search.regexp.%s", pattern);
+	for (i = 0; name[i]; i++) {
+		if (!IS_PRINTABLE (name[i])) {
+			name[i] = '.';
+		}
+	}
+	bench_start ();
+	r_search_begin (rs);
+	for (i = 0; i < len; i += 0x10000) {
+		r_search_update_i (rs, i, buf + i, R_MIN (0x10000, len - i));
+	}
+	bench_end (name, len);
+	if (!hits) {
+		eprintf ("no hits for %s\n", name);
+	}
+	r_search_free (rs);
+}
+
+int main(int argc, char **argv) {
+	int len, n, i;
+	char name[64];
+	ut8 *buf = load_corpus (&len);
+	if (!buf || len < 64) {
+		eprintf ("Run from the bench directory with the bins checked out\n");
+		return 1;
+	}
+	int max = bench_arg (argc, argv, 10000);
+	const ut8 **kws = calloc (max, sizeof (ut8 *));
+	int *kwlens = calloc (max, sizeof (int));
+	srand (1337);
+	// signatures are slices of the corpus so every keyword hits at least
+	// once, skipping padding so they look like real code and data
+	for (i = 0; i < max; i++) {
+		kwlens[i] = 4 + rand () % 13;
+		do {
+			kws[i] = buf + rnd (len - kwlens[i]);
+		} while (distinct_bytes (kws[i], kwlens[i]) < 3);
+	}
+	for (n = 1; n <= max; n *= 10) {
+		snprintf (name, sizeof (name), "search.scan.%d", n);
+		int a = run (name, R_SEARCH_ENGINE_SCAN, buf, len, kws, kwlens, n);
+		snprintf (name, sizeof (name), "search.aho.%d", n);
+		int b = run (name, R_SEARCH_ENGINE_AHO, buf, len, kws, kwlens, n);
+		if (a != b) {
+			eprintf ("hit count mismatch with %d keywords: %d vs %d\n", n, a, b);
+			return 1;
+		}
+	}
+	for (i = 0; regexps[i]; i++) {
+		run_regexp (regexps[i], buf, len);
+	}
+	free (kws);
+	free (kwlens);
+	free (buf);
+	return 0;
+}
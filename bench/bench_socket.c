@@ -0,0 +1,108 @@
+#include "bench.h"
+#include <r_socket.h>
+#include <r_th.h>
+
+// Request/response over loopback against the event loop server. Every
+// client thread keeps one connection and waits for each reply, so the
+// latency percentiles are round trips seen by a single client.
+
+typedef struct {
+	char port[16];
+	int requests;
+	ut64 *lat;
+	int errors;
+} BenchCtx;
+
+static bool reply(RSocketLoop *loop, RSocketConn *conn, const char *line, void *user) {
+	return r_socket_loop_write (conn, "ok\n", 3);
+}
+
+static int serve(RThread *th) {
+	r_socket_loop_run (th->user);
+	return 0;
+}
+
+static int client(RThread *th) {
+	BenchCtx *ctx = th->user;
+	char buf[64];
+	int i;
+	RSocket *s = r_socket_new (false);
+	if (!r_socket_connect_tcp (s, "127.0.0.1", ctx->port, 10)) {
+		ctx->errors++;
+		r_socket_free (s);
+		return 0;
+	}
+	for (i = 0; i < ctx->requests; i++) {
+		ut64 t0 = r_sys_now ();
+		r_socket_puts (s, "pd 1\n");
+		if (r_socket_gets (s, buf, sizeof (buf)) <= 0) {
+			ctx->errors++;
+			break;
+		}
+		ctx->lat[i] = r_sys_now () - t0;
+	}
+	r_socket_free (s);
+	return 0;
+}
+
+static int cmp_ut64(const void *a, const void *b) {
+	ut64 x = *(const ut64 *)a, y = *(const ut64 *)b;
+	return x < y? -1: x > y;
+}
+
+int main(int argc, char **argv) {
+	int total = bench_arg (argc, argv, 200000);
+	int nclients[] = { 1, 4, 16, 64, 256 };
+	char port[16];
+	char name[64];
+	int i, j;
+
+	RSocket *s = r_socket_new (false);
+	s->local = true;
+	for (i = 0; i < 100; i++) {
+		snprintf (port, sizeof (port), "%d", 20000 + (int)((r_sys_now () + i * 7919) % 30000));
+		if (r_socket_listen (s, port, NULL)) {
+			break;
+		}
+	}
+	RSocketLoop *loop = r_socket_loop_new (s, reply, NULL);
+	RThread *server = r_th_new (serve, loop, 0);
+
+	for (i = 0; i < sizeof (nclients) / sizeof (nclients[0]); i++) {
+		int n = nclients[i];
+		BenchCtx *ctx = calloc (n, sizeof (BenchCtx));
+		RThread **th = calloc (n, sizeof (RThread *));
+		int per = total / n;
+		ut64 *all = calloc ((size_t)per * n, sizeof (ut64));
+		int errors = 0;
+		snprintf (name, sizeof (name), "socket.requests.%dc", n);
+		bench_start ();
+		for (j = 0; j < n; j++) {
+			strcpy (ctx[j].port, port);
+			ctx[j].requests = per;
+			ctx[j].lat = all + (size_t)j * per;
+			th[j] = r_th_new (client, &ctx[j], 0);
+		}
+		for (j = 0; j < n; j++) {
+			r_th_wait (th[j]);
+			r_th_free (th[j]);
+			errors += ctx[j].errors;
+		}
+		bench_end (name, (ut64)per * n);
+		qsort (all, (size_t)per * n, sizeof (ut64), cmp_ut64);
+		printf ("%-32s p50 %6"PFMT64d"us p99 %6"PFMT64d"us p999 %6"PFMT64d"us\n", name,
+			all[(size_t)per * n / 2], all[(size_t)per * n * 99 / 100], all[(size_t)per * n * 999 / 1000]);
+		if (errors) {
+			eprintf ("%d client errors\n", errors);
+		}
+		free (all);
+		free (th);
+		free (ctx);
+	}
+	r_socket_loop_stop (loop);
+	r_th_wait (server);
+	r_th_free (server);
+	r_socket_loop_free (loop);
+	r_socket_free (s);
+	return 0;
+}
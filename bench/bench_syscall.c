@@ -0,0 +1,73 @@
+#include "bench.h"
+#include <r_syscall.h>
+
+// ESIL emulation resolves the syscall of every trapping instruction;
+// compare the table lookups with the raw sdb queries behind them.
+
+static const char *names[] = { "read", "write", "open", "close", "mmap", "brk", "ioctl", "exit", "execve", "socketcall" };
+#define NNAMES (sizeof (names) / sizeof (names[0]))
+
+int main(int argc, char **argv) {
+	int n = bench_arg (argc, argv, 10000000);
+	RSyscall *sc = r_syscall_new ();
+	char key[32];
+	ut64 sum = 0, ssum = 0;
+	int i;
+
+	if (!r_syscall_setup (sc, "x86", "linux", 32)) {
+		eprintf ("cannot load the linux x86 32 syscall table\n");
+		return 1;
+	}
+
+	bench_start ();
+	for (i = 0; i < n; i++) {
+		snprintf (key, sizeof (key), "0x80.%d", i % 400);
+		ssum += !!sdb_const_get (sc->db, key, NULL);
+	}
+	bench_end ("syscall.sdb.num", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		sum += !!r_syscall_get_i (sc, i % 400, 0x80);
+	}
+	bench_end ("syscall.get_i", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		sum += !!r_syscall_get_i (sc, i % 400, -1);
+	}
+	bench_end ("syscall.get_i.defswi", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		ssum += sdb_array_get_num (sc->db, names[i % NNAMES], 1, NULL);
+	}
+	bench_end ("syscall.sdb.name", n);
+
+	bench_restart ();
+	for (i = 0; i < n; i++) {
+		sum += r_syscall_get_num (sc, names[i % NNAMES]);
+	}
+	bench_end ("syscall.get_num", n);
+
+	// the item is what the anal hints ask for
+	bench_restart ();
+	for (i = 0; i < n / 10; i++) {
+		RSyscallItem *si = r_syscall_get (sc, i % 400, 0x80);
+		sum += si? si->args: 0;
+		r_syscall_item_free (si);
+	}
+	bench_end ("syscall.get", n / 10);
+
+	// emulation switches tables when the binary or asm.bits change
+	bench_restart ();
+	for (i = 0; i < 1000; i++) {
+		r_syscall_setup (sc, "x86", "linux", (i & 1)? 64: 32);
+	}
+	bench_end ("syscall.setup", 1000);
+	if (!sum || !ssum) {
+		eprintf ("unexpected zero sums\n");
+	}
+	r_syscall_free (sc);
+	return 0;
+}
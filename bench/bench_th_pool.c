@@ -0,0 +1,65 @@
+#include "bench.h"
+#include <r_th.h>
+#include <r_hash.h>
+
+#define BLOCK 4096
+
+typedef struct {
+	const ut8 *buf;
+	ut8 *digests;
+} HashCtx;
+
+// embarrassingly parallel kernel: sha256 of every 4K block
+static bool hash_blocks(RThread *th, void *user, ut64 from, ut64 to) {
+	HashCtx *ctx = user;
+	RHash *h = r_hash_new (true, R_HASH_SHA256);
+	ut64 off;
+	for (off = from; off < to; off += BLOCK) {
+		const ut8 *d = r_hash_do_sha256 (h, ctx->buf + off, BLOCK);
+		memcpy (ctx->digests + (off / BLOCK) * R_HASH_SIZE_SHA256, d, R_HASH_SIZE_SHA256);
+	}
+	r_hash_free (h);
+	return true;
+}
+
+int main(int argc, char **argv) {
+	int size = bench_arg (argc, argv, 256) * 1024 * 1024;
+	int ncpus = r_th_pool_ncpus ();
+	HashCtx ctx;
+	ut8 *serial;
+	char name[64];
+	int i, n;
+
+	ctx.buf = malloc (size);
+	ctx.digests = malloc ((size / BLOCK) * R_HASH_SIZE_SHA256);
+	serial = malloc ((size / BLOCK) * R_HASH_SIZE_SHA256);
+	if (!ctx.buf || !ctx.digests || !serial) {
+		return 1;
+	}
+	for (i = 0; i < size; i++) {
+		((ut8 *)ctx.buf)[i] = i * 7 + (i >> 12);
+	}
+
+	bench_start ();
+	hash_blocks (NULL, &ctx, 0, size);
+	bench_end ("th_pool.sha256.serial", size / BLOCK);
+	memcpy (serial, ctx.digests, (size / BLOCK) * R_HASH_SIZE_SHA256);
+
+	for (n = 1; n <= ncpus * 2; n *= 2) {
+		RThreadPool *pool = r_th_pool_new (n);
+		memset (ctx.digests, 0, (size / BLOCK) * R_HASH_SIZE_SHA256);
+		snprintf (name, sizeof (name), "th_pool.sha256.%d", n);
+		bench_restart ();
+		r_th_pool_parallel_for (pool, 0, size, BLOCK * 64, hash_blocks, &ctx);
+		bench_end (name, size / BLOCK);
+		if (memcmp (serial, ctx.digests, (size / BLOCK) * R_HASH_SIZE_SHA256)) {
+			eprintf ("th_pool.sha256.%d: digests differ from the serial run\n", n);
+			return 1;
+		}
+		r_th_pool_free (pool);
+	}
+	free ((void *)ctx.buf);
+	free (ctx.digests);
+	free (serial);
+	return 0;
+}
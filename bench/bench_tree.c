@@ -0,0 +1,84 @@
+#include "bench.h"
+
+static void count_node(RTreeNode *n, RTreeVisitor *vis) {
+	vis->data = (void *)((intptr_t)vis->data + 1);
+}
+
+static void bench_chain(int n) {
+	RTreeVisitor vis = { 0 };
+	RTree *t = r_tree_new ();
+	RTreeNode *node = NULL;
+	int i;
+
+	bench_start ();
+	for (i = 0; i < n; i++) {
+		node = r_tree_add_node (t, node, (void *)(intptr_t)i);
+	}
+	bench_end ("tree.chain.add", n);
+
+	vis.pre_visit = (RTreeNodeVisitCb)count_node;
+	bench_restart ();
+	r_tree_bfs (t, &vis);
+	bench_end ("tree.chain.bfs", (intptr_t)vis.data);
+
+	vis.data = NULL;
+	bench_restart ();
+	r_tree_dfs (t, &vis);
+	bench_end ("tree.chain.preorder", (intptr_t)vis.data);
+
+	vis.pre_visit = NULL;
+	vis.post_visit = (RTreeNodeVisitCb)count_node;
+	vis.data = NULL;
+	bench_restart ();
+	r_tree_dfs (t, &vis);
+	bench_end ("tree.chain.postorder", (intptr_t)vis.data);
+
+	bench_restart ();
+	r_tree_free (t);
+	bench_end ("tree.chain.free", n);
+}
+
+/* complete tree with fanout 4, close to what dominator trees look like */
+static void bench_bushy(int n) {
+	RTreeVisitor vis = { 0 };
+	RTree *t = r_tree_new ();
+	RTreeNode **nodes = malloc (sizeof (RTreeNode *) * n);
+	int i;
+
+	if (!nodes) {
+		return;
+	}
+	bench_start ();
+	nodes[0] = r_tree_add_node (t, NULL, (void *)0);
+	for (i = 1; i < n; i++) {
+		nodes[i] = r_tree_add_node (t, nodes[(i - 1) / 4], (void *)(intptr_t)i);
+	}
+	bench_end ("tree.bushy.add", n);
+
+	vis.pre_visit = (RTreeNodeVisitCb)count_node;
+	bench_restart ();
+	r_tree_bfs (t, &vis);
+	bench_end ("tree.bushy.bfs", (intptr_t)vis.data);
+
+	vis.data = NULL;
+	bench_restart ();
+	r_tree_dfs (t, &vis);
+	bench_end ("tree.bushy.preorder", (intptr_t)vis.data);
+
+	bench_restart ();
+	r_tree_reset (t);
+	bench_end ("tree.bushy.reset", n);
+
+	r_tree_free (t);
+	free (nodes);
+}
+
+int main(int argc, char **argv) {
+	int max = bench_arg (argc, argv, 10000000);
+	int n;
+	for (n = 100000; n <= max; n *= 10) {
+		bench_chain (n);
+		bench_bushy (n);
+	}
+	return 0;
+}
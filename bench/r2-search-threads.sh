@@ -0,0 +1,23 @@
+#!/bin/sh
+# Chunked search scaling with search.threads on multi-section binaries.
+# Usage: bench/r2-search-threads.sh [file ...]
+
+BINS="$(dirname "$0")/../bins"
+[ $# -eq 0 ] && set -- "${BINS}/elf/analysis/busybox-mips" "${BINS}/elf/analysis/busybox.m68k"
+NCPU=$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 4)
+
+for FILE in "$@" ; do
+	for IN in io.maps io.sections ; do
+		for CMD in "/ lib" "/x 00000000" "/e /[a-z]+[.]c/" ; do
+			T=1
+			while [ "$T" -le "${NCPU}" ]; do
+				printf "%-20s %-12s %-18s T%-3s " "$(basename "${FILE}")" "${IN}" "${CMD}" "${T}"
+				START=$(date +%s.%N)
+				r2 -q -e search.in="${IN}" -e search.threads="$T" -c "${CMD}" "${FILE}" > /dev/null
+				END=$(date +%s.%N)
+				echo "${START} ${END}" | awk '{ printf "%8.3fs\n", $2 - $1 }'
+				T=$((T * 2))
+			done
+		done
+	done
+done
@@ -0,0 +1,163 @@
+#!/usr/bin/env node
+// r2pipe throughput: NUL terminated text replies, one command at a time,
+// against r2pipe.framed=true with many commands in flight.
+// Usage: node bench/r2pipe-framed.js [file] [commands] [inflight]
+
+const spawn = require('child_process').spawn;
+const path = require('path');
+
+const file = process.argv[2] || path.join(__dirname, '..', 'bins', 'elf', 'analysis', 'busybox-mips');
+const count = +process.argv[3] || 100000;
+const inflight = +process.argv[4] || 64;
+
+// small commands like the ones automation sends in a loop
+function command (i) {
+  switch (i % 4) {
+    case 0: return '?v ' + i;
+    case 1: return 'pd 1 @ entry0+' + (i % 64);
+    case 2: return 'p8 16 @ ' + (i % 4096);
+    default: return 's';
+  }
+}
+
+function percentile (sorted, p) {
+  return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))];
+}
+
+function now () {
+  const [s, ns] = process.hrtime();
+  return s * 1e6 + ns / 1e3;
+}
+
+function r2spawn (args) {
+  return spawn('r2', ['-q0', '-N', '-e', 'scr.color=0'].concat(args, [file]), {
+    stdio: ['pipe', 'pipe', 'ignore']
+  });
+}
+
+// r2 -q0 writes a NUL when ready and one after every reply
+function runText () {
+  return new Promise(resolve => {
+    const r2 = r2spawn([]);
+    const replies = new Array(count);
+    const lat = new Array(count);
+    let chunks = [];
+    let ready = false;
+    let i = 0;
+    let t0, sent;
+    const send = () => {
+      sent = now();
+      r2.stdin.write(command(i) + '\n');
+    };
+    r2.stdout.on('data', data => {
+      let pos;
+      while ((pos = data.indexOf(0)) !== -1) {
+        chunks.push(data.slice(0, pos));
+        data = data.slice(pos + 1);
+        if (!ready) {
+          ready = true;
+          t0 = now();
+        } else {
+          lat[i] = now() - sent;
+          replies[i++] = Buffer.concat(chunks);
+        }
+        chunks = [];
+        if (i === count) {
+          r2.stdin.end('q!\n');
+          return resolve({ replies, lat, usec: now() - t0 });
+        }
+        send();
+      }
+      chunks.push(data);
+    });
+  });
+}
+
+// every frame is a 32 bit le payload length, a 32 bit le id and the payload
+function frame (id, payload) {
+  const buf = Buffer.alloc(8 + payload.length);
+  buf.writeUInt32LE(payload.length, 0);
+  buf.writeUInt32LE(id, 4);
+  payload.copy(buf, 8);
+  return buf;
+}
+
+function runFramed () {
+  return new Promise(resolve => {
+    const r2 = r2spawn(['-e', 'r2pipe.framed=true']);
+    const replies = new Array(count);
+    const lat = new Array(count);
+    const sent = new Array(count);
+    let pending = Buffer.alloc(0);
+    let next = 0;
+    let done = 0;
+    let t0;
+    const send = () => {
+      const bufs = [];
+      while (next < count && next - done < inflight) {
+        sent[next] = now();
+        bufs.push(frame(next, Buffer.from(command(next))));
+        next++;
+      }
+      if (bufs.length) {
+        r2.stdin.write(Buffer.concat(bufs));
+      }
+    };
+    r2.stdout.on('data', data => {
+      pending = pending.length ? Buffer.concat([pending, data]) : data;
+      while (pending.length >= 8) {
+        const len = pending.readUInt32LE(0);
+        if (pending.length < 8 + len) {
+          break;
+        }
+        const id = pending.readUInt32LE(4);
+        if (id === count) {
+          t0 = now();
+        } else {
+          lat[id] = now() - sent[id];
+          replies[id] = pending.slice(8, 8 + len);
+          done++;
+        }
+        pending = pending.slice(8 + len);
+      }
+      if (done === count) {
+        r2.stdin.end();
+        return resolve({ replies, lat, usec: now() - t0 });
+      }
+      if (t0 !== undefined) {
+        send();
+      }
+    });
+    // the reply to a first command tells r2 is up, like the NUL of -q0
+    r2.stdin.write(frame(count, Buffer.from('?v 0')));
+  });
+}
+
+function report (name, res) {
+  const sorted = res.lat.slice().sort((a, b) => a - b);
+  console.log(name.padEnd(24) +
+    String(Math.round(count * 1e6 / res.usec)).padStart(10) + ' cmd/s' +
+    '  p50 ' + percentile(sorted, 0.5).toFixed(1) + 'us' +
+    '  p99 ' + percentile(sorted, 0.99).toFixed(1) + 'us' +
+    '  p999 ' + percentile(sorted, 0.999).toFixed(1) + 'us');
+}
+
+(async () => {
+  console.log(file + ', ' + count + ' commands, ' + inflight + ' in flight');
+  const text = await runText();
+  report('text -0', text);
+  const framed = await runFramed();
+  report('framed', framed);
+  let bad = 0;
+  for (let i = 0; i < count; i++) {
+    if (!text.replies[i].equals(framed.replies[i])) {
+      if (!bad++) {
+        console.error('reply ' + i + ' differs for: ' + command(i));
+      }
+    }
+  }
+  if (bad) {
+    console.error(bad + ' replies differ between text and framed mode');
+    process.exit(1);
+  }
+})();
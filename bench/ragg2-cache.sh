@@ -0,0 +1,35 @@
+#!/bin/sh
+# Time ragg2 compiling the same programs again and again, without the
+# compile cache, with a cold one and with a warm one.
+# Usage: bench/ragg2-cache.sh [runs] [file.r ...]
+
+RUNS=${1:-50}
+[ $# -gt 0 ] && shift
+EGG="$(dirname "$0")/../unit/legacy_unit/egg"
+[ $# -eq 0 ] && set -- "${EGG}/hi.r" "${EGG}/write.r" "${EGG}/test.r"
+CACHE=$(mktemp -d)
+
+# run <times> <file.r ...>
+run() {
+	N=$1
+	shift
+	START=$(date +%s.%N)
+	i=0
+	while [ "$i" -lt "$N" ]; do
+		for R in "$@" ; do
+			ragg2 -a x86 -b 32 -k linux "$R" > /dev/null
+		done
+		i=$((i + 1))
+	done
+	END=$(date +%s.%N)
+	echo "${START} ${END} $N $#" | awk '{ printf "%8.3fs %8.2fms/compile\n", $2 - $1, ($2 - $1) * 1000 / ($3 * $4) }'
+}
+
+printf "%-12s " "uncached"
+run "${RUNS}" "$@"
+export RAGG2_CACHE="${CACHE}"
+printf "%-12s " "cold"
+run 1 "$@"
+printf "%-12s " "warm"
+run "${RUNS}" "$@"
+rm -rf "${CACHE}"
@@ -0,0 +1,31 @@
+#!/bin/sh
+# Block hashing and entropy scaling with the number of rahash2 threads.
+# Usage: bench/rahash2-threads.sh [size-in-MB]
+
+SIZE=${1:-512}
+FILE=/tmp/r2-bench-blocks.bin
+NCPU=$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 4)
+
+[ -f "${FILE}" ] || dd if=/dev/urandom of="${FILE}" bs=1M count="${SIZE}" 2>/dev/null
+
+for ALGO in md5 sha256 entropy ; do
+	T=1
+	while [ "$T" -le "${NCPU}" ]; do
+		printf "rahash2.%s.T%-3s " "${ALGO}" "${T}"
+		START=$(date +%s.%N)
+		rahash2 -T"$T" -B -b 4096 -a "${ALGO}" "${FILE}" > /dev/null
+		END=$(date +%s.%N)
+		echo "${START} ${END}" | awk '{ printf "%8.3fs\n", $2 - $1 }'
+		T=$((T * 2))
+	done
+done
+
+for T in 1 ${NCPU} ; do
+	printf "r2.p=e.T%-3s         " "$T"
+	START=$(date +%s.%N)
+	r2 -qn -e hash.threads="$T" -c 'p=e 4096' "${FILE}" > /dev/null
+	END=$(date +%s.%N)
+	echo "${START} ${END}" | awk '{ printf "%8.3fs\n", $2 - $1 }'
+done
+
+rm -f "${FILE}"
@@ -0,0 +1,10 @@
+# r2 script setting 200000 flags of 16 bytes from 0x100000 on, in a
+# fixed random order: awk -f flags-shuffled.awk
+BEGIN {
+	srand (1337)
+	for (i = 0; i < 200000; i++) o[i] = i
+	for (i = 199999; i > 0; i--) {
+		j = int (rand () * (i + 1)); t = o[i]; o[i] = o[j]; o[j] = t
+	}
+	for (i = 0; i < 200000; i++) printf "f sym.%d 16 @ 0x%x\n", o[i], 1048576 + o[i] * 16
+}
@@ -0,0 +1,10 @@
+# r2 script adding a graph of 300 nodes, chained one after the other
+# with forward branches and loops: awk -f graph-300.awk
+BEGIN {
+	for (i = 0; i < 300; i++) printf "agn bb.%d \"cmp eax, %d\"\n", i, i
+	for (i = 0; i + 1 < 300; i++) {
+		printf "age bb.%d bb.%d\n", i, i + 1
+		if (i % 3 == 0 && i + 5 < 300) printf "age bb.%d bb.%d\n", i, i + 5
+		if (i % 7 == 6) printf "age bb.%d bb.%d\n", i, i - 4
+	}
+}
@@ -74,6 +74,32 @@ printdiff() {
   fi
 }
 
+# For SHELLCMD tests: runs the same r2 commands on a file once per
+# eval variable given and fails, showing the diff against the first
+# run, unless every run prints the same non empty output.
+# Usage: same_output "cmds" file var=value var=value ...
+same_output() {
+  _SO_CMDS="$1"
+  _SO_FILE="$2"
+  shift 2
+  _SO_FIRST=
+  for _SO_EVAL in "$@" ; do
+    ${R2} -e scr.color=0 -N -q -e "${_SO_EVAL}" -c "${_SO_CMDS}" "${_SO_FILE}" > "${TMP_DIR}/same.out"
+    if [ -z "${_SO_FIRST}" ]; then
+      if [ ! -s "${TMP_DIR}/same.out" ]; then
+        echo "No output with -e ${_SO_EVAL}"
+        return 1
+      fi
+      mv "${TMP_DIR}/same.out" "${TMP_DIR}/same.ref"
+      _SO_FIRST="${_SO_EVAL}"
+    elif ! ${DIFF} ${DIFF_ARG} -u "${TMP_DIR}/same.ref" "${TMP_DIR}/same.out" > "${TMP_DIR}/same.diff"; then
+      echo "-e ${_SO_FIRST} vs -e ${_SO_EVAL}:"
+      cat "${TMP_DIR}/same.diff"
+      return 1
+    fi
+  done
+}
+
 COUNT=0
 
 dump_test() {
@@ -41,12 +41,126 @@ int test_r_base64_encode(void) {
 	mu_end;
 }
 
+static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Plain RFC 4648 encoder used as the reference for the vectorized paths
+static int ref_encode(char *out, const ut8 *in, int len) {
+	int i, o = 0;
+	for (i = 0; i + 2 < len; i += 3) {
+		out[o++] = b64[in[i] >> 2];
+		out[o++] = b64[((in[i] & 3) << 4) | (in[i + 1] >> 4)];
+		out[o++] = b64[((in[i + 1] & 15) << 2) | (in[i + 2] >> 6)];
+		out[o++] = b64[in[i + 2] & 63];
+	}
+	if (i < len) {
+		out[o++] = b64[in[i] >> 2];
+		if (i + 1 < len) {
+			out[o++] = b64[((in[i] & 3) << 4) | (in[i + 1] >> 4)];
+			out[o++] = b64[(in[i + 1] & 15) << 2];
+		} else {
+			out[o++] = b64[(in[i] & 3) << 4];
+			out[o++] = '=';
+		}
+		out[o++] = '=';
+	}
+	out[o] = 0;
+	return o;
+}
+
+#define MAXLEN 4096
+#define ALIGNS 32
+
+bool test_r_base64_encode_all_lengths(void) {
+	ut8 *in = malloc (MAXLEN + ALIGNS);
+	char *ref = malloc (MAXLEN * 2 + ALIGNS);
+	char *out = malloc (MAXLEN * 2 + ALIGNS);
+	int i, len, bad = 0;
+	srand (1337);
+	for (i = 0; i < MAXLEN + ALIGNS; i++) {
+		in[i] = rand ();
+	}
+	// every length crosses the vector block size and its tail differently,
+	// the source offset changes the alignment the vector loads start from
+	for (len = 0; len <= MAXLEN; len++) {
+		int align = len % ALIGNS;
+		int reflen = ref_encode (ref, in + align, len);
+		int outlen = r_base64_encode (out + (len % 7), in + align, len);
+		if (outlen != reflen || strcmp (out + (len % 7), ref)) {
+			bad++;
+		}
+	}
+	mu_assert_eq (bad, 0, "encoding of lengths 0..4096 matches the reference");
+	free (in);
+	free (ref);
+	free (out);
+	mu_end;
+}
+
+bool test_r_base64_decode_all_lengths(void) {
+	ut8 *in = malloc (MAXLEN);
+	ut8 *dec = malloc (MAXLEN + ALIGNS);
+	char *enc = malloc (MAXLEN * 2);
+	int i, len, bad = 0;
+	srand (31337);
+	for (i = 0; i < MAXLEN; i++) {
+		in[i] = rand ();
+	}
+	for (len = 0; len <= MAXLEN; len++) {
+		int enclen = ref_encode (enc, in, len);
+		ut8 *d = dec + (len % ALIGNS);
+		int declen = r_base64_decode (d, enc, enclen);
+		if (declen != len || memcmp (d, in, len)) {
+			bad++;
+		}
+		char *dyn = (char *)r_base64_decode_dyn (enc, enclen);
+		if (len && (!dyn || memcmp (dyn, in, len))) {
+			bad++;
+		}
+		free (dyn);
+	}
+	mu_assert_eq (bad, 0, "decoding of lengths 0..4096 matches the input");
+	free (in);
+	free (dec);
+	free (enc);
+	mu_end;
+}
+
+bool test_r_base64_decode_invalid_all_positions(void) {
+	const char invalid[] = { '\x01', '\x80', '\xff', '-', '_', '.', ' ', '*' };
+	ut8 *in = malloc (256);
+	ut8 *dec = malloc (256);
+	char enc[512];
+	int i, pos, bad = 0;
+	for (i = 0; i < 256; i++) {
+		in[i] = i * 7;
+	}
+	int enclen = ref_encode (enc, in, 255);
+	// an invalid byte must be caught wherever it falls, inside a vector
+	// block or in the scalar tail
+	for (pos = 0; pos < enclen; pos++) {
+		char saved = enc[pos];
+		enc[pos] = invalid[pos % sizeof (invalid)];
+		if (r_base64_decode (dec, enc, enclen) != -1) {
+			bad++;
+		}
+		enc[pos] = saved;
+	}
+	mu_assert_eq (bad, 0, "invalid characters are rejected at every offset");
+	mu_assert_eq (r_base64_decode (dec, enc, enclen), 255, "restored input decodes");
+	free (in);
+	free (dec);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_r_base64_decode_dyn);
 	mu_run_test(test_r_base64_decode);
 	mu_run_test(test_r_base64_decode_invalid);
 	mu_run_test(test_r_base64_encode_dyn);
 	mu_run_test(test_r_base64_encode);
+	mu_run_test(test_r_base64_encode_all_lengths);
+	mu_run_test(test_r_base64_decode_all_lengths);
+	mu_run_test(test_r_base64_decode_invalid_all_positions);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,157 @@
+#include <r_util.h>
+#include "minunit.h"
+
+#define mu_assert_big_eq(actual, expected, message) \
+	mu_assert (message, r_big_cmp ((actual), (expected)) == 0)
+
+static void big_pow2(RNumBig *n, int bits) {
+	RNumBig two;
+	int i;
+	r_big_set_st (n, 1);
+	r_big_set_st (&two, 2);
+	for (i = 0; i < bits; i++) {
+		r_big_mul (n, n, &two);
+	}
+}
+
+// random number with the given amount of decimal digits, sign included
+static void big_random(RNumBig *n, int digits) {
+	char s[2048];
+	int i = 0;
+	if (rand () & 1) {
+		s[i++] = '-';
+	}
+	s[i++] = '1' + rand () % 9;
+	while (--digits > 0) {
+		s[i++] = '0' + rand () % 10;
+	}
+	s[i] = 0;
+	r_big_set_str (n, s);
+}
+
+bool test_r_big_small(void) {
+	RNumBig n1, n2, n3, exp;
+
+	r_big_set_st (&n2, -2);
+	r_big_set_str (&n3, "-3");
+	r_big_mul (&n2, &n2, &n3);
+	r_big_set_st (&exp, 6);
+	mu_assert_big_eq (&n2, &exp, "-2 * -3");
+
+	r_big_set_st (&n1, 2);
+	r_big_set_st (&n2, 3);
+	r_big_mul (&n1, &n1, &n2);
+	mu_assert_big_eq (&n1, &exp, "2 * 3");
+
+	r_big_set_st (&n3, 923459999);
+	r_big_mul (&n1, &n2, &n3);
+	r_big_mul (&n2, &n1, &n3);
+	r_big_mul (&n1, &n2, &n3);
+	r_big_set_str (&exp, "2362520137438202663911139997");
+	mu_assert_big_eq (&n1, &exp, "3 * 923459999^3");
+
+	r_big_set_st64 (&n2, 9999923459999999LL);
+	r_big_set_st64 (&n3, 9999992345999999LL);
+	r_big_mul (&n1, &n2, &n3);
+	r_big_mul (&n2, &n1, &n3);
+	r_big_mul (&n1, &n2, &n3);
+	r_big_set_str (&exp, "9999900498193322123825958580013165023967572117222628099502000001");
+	mu_assert_big_eq (&n1, &exp, "st64 products");
+
+	r_big_set_st (&n1, 17);
+	r_big_set_st (&n2, -5);
+	r_big_add (&n3, &n1, &n2);
+	r_big_set_st (&exp, 12);
+	mu_assert_big_eq (&n3, &exp, "17 + -5");
+	r_big_sub (&n3, &n2, &n1);
+	r_big_set_st (&exp, -22);
+	mu_assert_big_eq (&n3, &exp, "-5 - 17");
+	r_big_div (&n3, &n1, &n2);
+	r_big_set_st (&exp, -3);
+	mu_assert_big_eq (&n3, &exp, "17 / -5 truncates");
+	mu_assert ("cmp less", r_big_cmp (&n2, &n1) < 0);
+	mu_assert ("cmp greater", r_big_cmp (&n1, &n2) > 0);
+	mu_end;
+}
+
+bool test_r_big_wide(void) {
+	RNumBig a, b, q, exp, one;
+
+	big_pow2 (&a, 256);
+	r_big_set_str (&exp, "115792089237316195423570985008687907853269984665640564039457584007913129639936");
+	mu_assert_big_eq (&a, &exp, "2^256");
+
+	// (2^4096 - 1) / (2^2048 + 1) == 2^2048 - 1
+	r_big_set_st (&one, 1);
+	big_pow2 (&a, 4096);
+	r_big_sub (&a, &a, &one);
+	big_pow2 (&b, 2048);
+	r_big_add (&b, &b, &one);
+	r_big_div (&q, &a, &b);
+	big_pow2 (&exp, 2048);
+	r_big_sub (&exp, &exp, &one);
+	mu_assert_big_eq (&q, &exp, "4096 bit division");
+
+	// 2^2048 * 2^2048 crosses the karatsuba threshold
+	big_pow2 (&a, 2048);
+	r_big_mul (&q, &a, &a);
+	big_pow2 (&exp, 4096);
+	mu_assert_big_eq (&q, &exp, "4096 bit square");
+	mu_end;
+}
+
+bool test_r_big_random(void) {
+	int sizes[] = { 1, 9, 19, 20, 40, 78, 155, 309, 617, 1000, 1233 };
+	RNumBig a, b, c, t1, t2, t3;
+	char msg[128];
+	int i, s;
+
+	srand (0xb16);
+	for (s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++) {
+		for (i = 0; i < 20; i++) {
+			big_random (&a, sizes[s]);
+			big_random (&b, 1 + rand () % sizes[s]);
+			big_random (&c, sizes[s]);
+
+			snprintf (msg, sizeof (msg), "%d digits: (a + b) - b == a", sizes[s]);
+			r_big_add (&t1, &a, &b);
+			r_big_sub (&t1, &t1, &b);
+			mu_assert_big_eq (&t1, &a, msg);
+
+			snprintf (msg, sizeof (msg), "%d digits: a * b == b * a", sizes[s]);
+			r_big_mul (&t1, &a, &b);
+			r_big_mul (&t2, &b, &a);
+			mu_assert_big_eq (&t1, &t2, msg);
+
+			snprintf (msg, sizeof (msg), "%d digits: (a * b) / b == a", sizes[s]);
+			r_big_div (&t2, &t1, &b);
+			mu_assert_big_eq (&t2, &a, msg);
+
+			snprintf (msg, sizeof (msg), "%d digits: a * (b + c) == a * b + a * c", sizes[s]);
+			r_big_add (&t2, &b, &c);
+			r_big_mul (&t2, &a, &t2);
+			r_big_mul (&t3, &a, &c);
+			r_big_add (&t3, &t1, &t3);
+			mu_assert_big_eq (&t2, &t3, msg);
+
+			snprintf (msg, sizeof (msg), "%d digits: (a / b) * b + a %% b == a", sizes[s]);
+			r_big_div (&t1, &a, &b);
+			r_big_mul (&t1, &t1, &b);
+			r_big_mod (&t2, &a, &b);
+			r_big_add (&t1, &t1, &t2);
+			mu_assert_big_eq (&t1, &a, msg);
+		}
+	}
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_big_small);
+	mu_run_test(test_r_big_wide);
+	mu_run_test(test_r_big_random);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
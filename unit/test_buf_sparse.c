@@ -0,0 +1,127 @@
+#include <r_util.h>
+#include "minunit.h"
+
+#define WINDOW 0x10000
+#define BASE 0x400000ULL
+
+// value read back from addresses that were never written, taken from
+// the hole between two chunks since reads past the last one fail
+static ut8 sparse_fill(void) {
+	RBuffer *b = r_buf_new_sparse ();
+	ut8 c = 'x';
+	r_buf_write_at (b, BASE, (ut8 *)"A", 1);
+	r_buf_write_at (b, BASE + 2, (ut8 *)"B", 1);
+	r_buf_read_at (b, BASE + 1, &c, 1);
+	r_buf_free (b);
+	return c;
+}
+
+bool test_r_buf_sparse_overlap(void) {
+	ut8 data[128] = {0};
+	ut8 big[0x200];
+	RBuffer *b = r_buf_new_sparse ();
+	ut8 fill = sparse_fill ();
+	r_buf_write_at (b, 0x100, (ut8 *)"Hello World", 12);
+	r_buf_write_at (b, 0x200, (ut8 *)"This Rocks!", 12);
+	r_buf_write_at (b, 0x102, (ut8 *)"XX", 2);
+	memset (data, 0, sizeof (data));
+	r_buf_read_at (b, 0x101, data, 12);
+	mu_assert_streq ((char *)data, "eXXo World", "write inside a chunk");
+
+	r_buf_write_at (b, 0xf8, (ut8 *)"0123456789abcdef", 16);
+	memset (data, 0, sizeof (data));
+	r_buf_read_at (b, 0xf8, data, 16);
+	mu_assert ("write over the start of a chunk", !memcmp (data, "0123456789abcdef", 16));
+	memset (data, 0, sizeof (data));
+	r_buf_read_at (b, 0x108, data, 4);
+	mu_assert_streq ((char *)data, "rld", "tail of the old chunk survives");
+	memset (data, 0, sizeof (data));
+	r_buf_read_at (b, 0x200, data, 12);
+	mu_assert_streq ((char *)data, "This Rocks!", "unrelated chunk untouched");
+
+	// a write covering several chunks replaces all of them; the closing
+	// chunk keeps the read of its end inside the buffer
+	r_buf_write_at (b, 0x260, (ut8 *)"Z", 1);
+	memset (big, 'A', sizeof (big));
+	r_buf_write_at (b, 0x50, big, sizeof (big));
+	memset (data, fill ^ 0xff, sizeof (data));
+	r_buf_read_at (b, 0x24f, data, 4);
+	mu_assert ("write covering every chunk", data[0] == 'A' && data[1] == fill);
+	mu_assert_eq (r_buf_sparse_count (b), 2, "covering write merges the chunks under it");
+	r_buf_free (b);
+	mu_end;
+}
+
+bool test_r_buf_sparse_adjacent(void) {
+	ut8 data[16] = {0};
+	RBuffer *b = r_buf_new_sparse ();
+	ut8 fill = sparse_fill ();
+	r_buf_write_at (b, 0x1004, (ut8 *)"EFGH", 4);
+	r_buf_write_at (b, 0x1000, (ut8 *)"ABCD", 4);
+	r_buf_write_at (b, 0x1008, (ut8 *)"IJKL", 4);
+	// closing chunk, so the reads past 0x100c stay inside the buffer
+	r_buf_write_at (b, 0x1020, (ut8 *)"Z", 1);
+	mu_assert_eq (r_buf_sparse_count (b), 2, "adjacent writes coalesce");
+	memset (data, fill ^ 0xff, sizeof (data));
+	r_buf_read_at (b, 0xfff, data, 14);
+	mu_assert_eq (data[0], fill, "byte before the chunk");
+	mu_assert ("coalesced contents", !memcmp (data + 1, "ABCDEFGHIJKL", 12));
+	mu_assert_eq (data[13], fill, "byte after the chunk");
+
+	// a one byte gap keeps chunks apart until it is filled
+	r_buf_write_at (b, 0x100d, (ut8 *)"N", 1);
+	mu_assert_eq (r_buf_sparse_count (b), 3, "gap keeps chunks apart");
+	r_buf_write_at (b, 0x100c, (ut8 *)"M", 1);
+	mu_assert_eq (r_buf_sparse_count (b), 2, "filling the gap coalesces");
+	memset (data, 0, sizeof (data));
+	r_buf_read_at (b, 0x1000, data, 14);
+	mu_assert ("gap contents", !memcmp (data, "ABCDEFGHIJKLMN", 14));
+	r_buf_free (b);
+	mu_end;
+}
+
+bool test_r_buf_sparse_random(void) {
+	ut8 *ref = malloc (WINDOW);
+	ut8 *got = malloc (WINDOW);
+	ut8 chunk[64];
+	RBuffer *b = r_buf_new_sparse ();
+	int i, j;
+
+	memset (ref, sparse_fill (), WINDOW);
+	// bound the window so every read below falls between chunks
+	r_buf_write_at (b, BASE, ref, 1);
+	r_buf_write_at (b, BASE + WINDOW - 1, ref, 1);
+	srand (1337);
+	// out of order, overlapping and adjacent writes against a flat model
+	for (i = 0; i < 20000; i++) {
+		int off = rand () % (WINDOW - sizeof (chunk));
+		int len = 1 + rand () % sizeof (chunk);
+		for (j = 0; j < len; j++) {
+			chunk[j] = rand ();
+		}
+		r_buf_write_at (b, BASE + off, chunk, len);
+		memcpy (ref + off, chunk, len);
+		if (!(i % 1000)) {
+			int roff = rand () % (WINDOW - 4096);
+			r_buf_read_at (b, BASE + roff, got, 4096);
+			mu_assert ("random read", !memcmp (got, ref + roff, 4096));
+		}
+	}
+	r_buf_read_at (b, BASE, got, WINDOW);
+	mu_assert ("whole window", !memcmp (got, ref, WINDOW));
+	r_buf_free (b);
+	free (ref);
+	free (got);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_buf_sparse_overlap);
+	mu_run_test(test_r_buf_sparse_adjacent);
+	mu_run_test(test_r_buf_sparse_random);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
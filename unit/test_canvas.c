@@ -0,0 +1,278 @@
+#include <r_cons.h>
+#include "minunit.h"
+
+#define W 80
+#define H 30
+#define CELL 8
+
+// A minimal terminal: the damage output is played on it and the result
+// must look like the screen printed from a full redraw of the canvas.
+typedef struct {
+	char cell[H][W][CELL];
+	int w, h;
+	int x, y;
+} Screen;
+
+static void screen_clear(Screen *s, int w, int h) {
+	int x, y;
+	s->w = w;
+	s->h = h;
+	s->x = s->y = 0;
+	for (y = 0; y < H; y++) {
+		for (x = 0; x < W; x++) {
+			strcpy (s->cell[y][x], " ");
+		}
+	}
+}
+
+static void screen_put(Screen *s, const char *ch, int len) {
+	if (s->x < s->w && s->y < s->h) {
+		memcpy (s->cell[s->y][s->x], ch, len);
+		s->cell[s->y][s->x][len] = 0;
+	}
+	s->x++;
+}
+
+static int utf8_len(ut8 c) {
+	return c < 0x80? 1: c < 0xe0? 2: c < 0xf0? 3: 4;
+}
+
+static void screen_play(Screen *s, const char *out) {
+	const char *p = out;
+	while (*p) {
+		if (*p == 0x1b && p[1] == '[') {
+			int a = 0, b = 0, n = 0;
+			p += 2;
+			while (*p && !((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z'))) {
+				if (*p == ';') {
+					n++;
+				} else if (n == 0) {
+					a = a * 10 + (*p - '0');
+				} else {
+					b = b * 10 + (*p - '0');
+				}
+				p++;
+			}
+			switch (*p) {
+			case 'H':
+				s->y = a? a - 1: 0;
+				s->x = b? b - 1: 0;
+				break;
+			case 'J':
+				screen_clear (s, s->w, s->h);
+				break;
+			case 'K':
+				while (s->x < s->w) {
+					screen_put (s, " ", 1);
+				}
+				break;
+			}
+			// colors and other attributes do not change the cells
+			if (*p) {
+				p++;
+			}
+		} else if (*p == '\n') {
+			s->x = 0;
+			s->y++;
+			p++;
+		} else if (*p == '\r') {
+			s->x = 0;
+			p++;
+		} else {
+			int len = R_MIN (utf8_len (*p), CELL - 1);
+			screen_put (s, p, len);
+			p += len;
+		}
+	}
+}
+
+static bool same_screen(Screen *a, Screen *b) {
+	int x, y;
+	for (y = 0; y < a->h; y++) {
+		for (x = 0; x < a->w; x++) {
+			if (strcmp (a->cell[y][x], b->cell[y][x])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Screen printed from scratch from the whole canvas
+static void full_redraw(RConsCanvas *can, Screen *s) {
+	char *str = r_cons_canvas_to_string (can);
+	screen_clear (s, can->w, can->h);
+	screen_play (s, str);
+	free (str);
+}
+
+// Nodes and edges of legacy_unit/cons/graph.c
+typedef struct {
+	int x, y, w, h;
+	ut64 addr;
+	const char *text;
+} Node;
+
+static Node nodes[] = {
+	{ 25, 4, 18, 6, 0x8048320, "push ebp\nmov esp, ebp\njz 0x8048332" },
+	{ 10, 13, 18, 5, 0x8048332, "xor eax, eax\nint 0x80\n" },
+	{ 30, 13, 18, 5, 0x8048324, "pop ebp\nret" },
+};
+#define NNODES (sizeof (nodes) / sizeof (nodes[0]))
+
+static void node_print(RConsCanvas *can, Node *n, bool cur) {
+	char title[128];
+	n->w = r_str_bounds (n->text, &n->h);
+	n->w = R_MAX (18, n->w + 4);
+	n->h += 4;
+	if (cur) {
+		r_cons_canvas_fill (can, n->x, n->y, n->w, n->h, '.');
+		snprintf (title, sizeof (title), "-[ 0x%08"PFMT64x" ]-", n->addr);
+	} else {
+		snprintf (title, sizeof (title), "   0x%08"PFMT64x"   ", n->addr);
+	}
+	r_cons_canvas_gotoxy (can, n->x + 2, n->y + 2);
+	r_cons_canvas_write (can, n->text);
+	r_cons_canvas_gotoxy (can, n->x + 1, n->y + 1);
+	r_cons_canvas_write (can, title);
+	r_cons_canvas_box (can, n->x, n->y, n->w, n->h, NULL);
+}
+
+static void draw(RConsCanvas *can, int cur) {
+	RCanvasLineStyle style = { 0 };
+	int i;
+	r_cons_canvas_clear (can);
+	for (i = 1; i < NNODES; i++) {
+		int xinc = 3 + i * 3;
+		r_cons_canvas_line (can, nodes[0].x + xinc, nodes[0].y + nodes[0].h,
+			nodes[i].x + xinc, nodes[i].y, &style);
+	}
+	for (i = 0; i < NNODES; i++) {
+		node_print (can, &nodes[i], i == cur);
+	}
+}
+
+bool test_r_cons_canvas_damage_first_frame(void) {
+	Screen ref, term;
+	RConsCanvas *can = r_cons_canvas_new (W, H);
+	draw (can, 0);
+	char *out = r_cons_canvas_to_string_damage (can);
+	screen_clear (&term, W, H);
+	screen_play (&term, out);
+	full_redraw (can, &ref);
+	mu_assert ("first frame draws everything", same_screen (&ref, &term));
+	free (out);
+
+	// redrawing the same scene changes nothing on the terminal
+	draw (can, 0);
+	out = r_cons_canvas_to_string_damage (can);
+	mu_assert_eq ((int)strlen (out), 0, "no damage without changes");
+	free (out);
+	r_cons_canvas_free (can);
+	mu_end;
+}
+
+bool test_r_cons_canvas_damage_moves(void) {
+	// the keypresses of the legacy interactive test
+	const char *keys = "jjjlllkkhhJLKH\tjjll\tkkhhHHJJ\tL";
+	Screen ref, term;
+	RConsCanvas *can = r_cons_canvas_new (W, H);
+	Node saved[NNODES];
+	int cur = 0, frame = 0, bad = 0;
+	size_t full_bytes = 0, damage_bytes = 0;
+	const char *k;
+
+	memcpy (saved, nodes, sizeof (nodes));
+	screen_clear (&term, W, H);
+	for (k = keys; ; k++) {
+		draw (can, cur);
+		char *out = r_cons_canvas_to_string_damage (can);
+		char *full = r_cons_canvas_to_string (can);
+		screen_play (&term, out);
+		full_redraw (can, &ref);
+		if (!same_screen (&ref, &term)) {
+			bad++;
+		}
+		if (frame++) {
+			damage_bytes += strlen (out);
+			full_bytes += strlen (full);
+		}
+		free (out);
+		free (full);
+		if (!*k) {
+			break;
+		}
+		Node *n = &nodes[cur];
+		switch (*k) {
+		case '\t': cur = (cur + 1) % NNODES; break;
+		case 'j': n->y++; break;
+		case 'k': n->y--; break;
+		case 'h': n->x--; break;
+		case 'l': n->x++; break;
+		case 'J': n->y += 2; break;
+		case 'K': n->y -= 2; break;
+		case 'H': n->x -= 2; break;
+		case 'L': n->x += 2; break;
+		}
+	}
+	memcpy (nodes, saved, sizeof (nodes));
+	mu_assert_eq (bad, 0, "every frame matches a full redraw");
+	// moving one node touches a few lines, not the whole canvas
+	mu_assert ("damage is smaller than full redraws", damage_bytes * 2 < full_bytes);
+	r_cons_canvas_free (can);
+	mu_end;
+}
+
+bool test_r_cons_canvas_damage_edges(void) {
+	Screen ref, term;
+	RConsCanvas *can = r_cons_canvas_new (W, H);
+	Node saved[NNODES];
+	int i, bad = 0;
+
+	memcpy (saved, nodes, sizeof (nodes));
+	screen_clear (&term, W, H);
+	srand (1337);
+	// nodes partially outside the canvas and crossing each other
+	for (i = 0; i < 500; i++) {
+		Node *n = &nodes[rand () % NNODES];
+		n->x += rand () % 9 - 4;
+		n->y += rand () % 7 - 3;
+		n->x = R_MAX (-10, R_MIN (W + 5, n->x));
+		n->y = R_MAX (-5, R_MIN (H + 5, n->y));
+		draw (can, i % NNODES);
+		char *out = r_cons_canvas_to_string_damage (can);
+		screen_play (&term, out);
+		full_redraw (can, &ref);
+		if (!same_screen (&ref, &term)) {
+			bad++;
+		}
+		free (out);
+	}
+	mu_assert_eq (bad, 0, "random moves match a full redraw");
+
+	// after a resize the whole canvas is damaged again
+	r_cons_canvas_resize (can, W - 20, H - 10);
+	draw (can, 0);
+	char *out = r_cons_canvas_to_string_damage (can);
+	screen_clear (&term, W - 20, H - 10);
+	screen_play (&term, out);
+	full_redraw (can, &ref);
+	mu_assert ("resized canvas matches a full redraw", same_screen (&ref, &term));
+	free (out);
+	memcpy (nodes, saved, sizeof (nodes));
+	r_cons_canvas_free (can);
+	mu_end;
+}
+
+int all_tests() {
+	r_cons_new ();
+	mu_run_test(test_r_cons_canvas_damage_first_frame);
+	mu_run_test(test_r_cons_canvas_damage_moves);
+	mu_run_test(test_r_cons_canvas_damage_edges);
+	r_cons_free ();
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
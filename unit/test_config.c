@@ -0,0 +1,159 @@
+#include <r_config.h>
+#include "minunit.h"
+
+typedef struct {
+	RConfig *cfg;
+	int calls;
+} CbCtx;
+
+// clamps the value like asm.bits or scr.columns setters do
+static int clamp_cb(void *user, void *data) {
+	RConfigNode *node = data;
+	((CbCtx *)user)->calls++;
+	if (node->i_value > 64) {
+		node->i_value = 64;
+		free (node->value);
+		node->value = strdup ("64");
+	}
+	return true;
+}
+
+static int reject_cb(void *user, void *data) {
+	RConfigNode *node = data;
+	return node->i_value != 13;
+}
+
+// changes a second variable from the setter of the first one
+static int chain_cb(void *user, void *data) {
+	CbCtx *ctx = user;
+	RConfigNode *node = data;
+	r_config_set_i (ctx->cfg, "test.derived", node->i_value * 2);
+	return true;
+}
+
+bool test_r_config_get_set(void) {
+	// from legacy_unit/config/test.c
+	RConfig *cfg = r_config_new (NULL);
+	r_config_set (cfg, "foo", "bar");
+	r_config_set_i (cfg, "bar", 33);
+	r_config_lock (cfg, 1);
+	mu_assert_streq (r_config_get (cfg, "foo"), "bar", "string value");
+	mu_assert_eq ((int)r_config_get_i (cfg, "bar"), 33, "integer value");
+	r_config_free (cfg);
+	mu_end;
+}
+
+bool test_r_config_handle(void) {
+	RConfig *cfg = r_config_new (NULL);
+	r_config_set_i (cfg, "asm.bits", 32);
+	r_config_set (cfg, "asm.bytes", "true");
+	r_config_set (cfg, "asm.arch", "x86");
+	RConfigHandle *bits = r_config_handle_new (cfg, "asm.bits");
+	RConfigHandle *bytes = r_config_handle_new (cfg, "asm.bytes");
+	RConfigHandle *arch = r_config_handle_new (cfg, "asm.arch");
+	mu_assert ("handles resolve", bits && bytes && arch);
+	mu_assert_eq ((int)r_config_handle_get_i (bits), 32, "integer through the handle");
+	mu_assert ("bool through the handle", r_config_handle_get_b (bytes));
+	mu_assert_streq (r_config_handle_get (arch), "x86", "string through the handle");
+
+	// setting by name is visible through existing handles
+	r_config_set_i (cfg, "asm.bits", 64);
+	r_config_set (cfg, "asm.bytes", "false");
+	r_config_set (cfg, "asm.arch", "arm");
+	mu_assert_eq ((int)r_config_handle_get_i (bits), 64, "integer after set_i");
+	mu_assert ("bool after set", !r_config_handle_get_b (bytes));
+	mu_assert_streq (r_config_handle_get (arch), "arm", "string after set");
+	// the integer view of a string value follows it
+	r_config_set (cfg, "asm.bits", "0x10");
+	mu_assert_eq ((int)r_config_handle_get_i (bits), 16, "integer after a string set");
+	r_config_set (cfg, "asm.bytes", "1");
+	mu_assert ("bool after a numeric set", r_config_handle_get_b (bytes));
+
+	r_config_handle_free (bits);
+	r_config_handle_free (bytes);
+	r_config_handle_free (arch);
+	r_config_free (cfg);
+	mu_end;
+}
+
+bool test_r_config_handle_callbacks(void) {
+	CbCtx ctx = { 0 };
+	RConfig *cfg = r_config_new (&ctx);
+	ctx.cfg = cfg;
+	r_config_set_i_cb (cfg, "test.clamp", 8, clamp_cb);
+	r_config_set_i_cb (cfg, "test.reject", 1, reject_cb);
+	r_config_set_i (cfg, "test.derived", 0);
+	r_config_set_i_cb (cfg, "test.chain", 0, chain_cb);
+	RConfigHandle *clamp = r_config_handle_new (cfg, "test.clamp");
+	RConfigHandle *reject = r_config_handle_new (cfg, "test.reject");
+	RConfigHandle *derived = r_config_handle_new (cfg, "test.derived");
+
+	// a setter that rewrites the value wins over the value that was set
+	r_config_set_i (cfg, "test.clamp", 1000);
+	mu_assert_eq ((int)r_config_handle_get_i (clamp), 64, "value clamped by the setter");
+	mu_assert_eq ((int)r_config_get_i (cfg, "test.clamp"), 64, "string lookup agrees");
+	r_config_set_i (cfg, "test.clamp", 20);
+	mu_assert_eq ((int)r_config_handle_get_i (clamp), 20, "value accepted by the setter");
+
+	// a setter that refuses the value leaves the old one in place
+	r_config_set_i (cfg, "test.reject", 13);
+	mu_assert_eq ((int)r_config_handle_get_i (reject), 1, "value rejected by the setter");
+	r_config_set_i (cfg, "test.reject", 7);
+	mu_assert_eq ((int)r_config_handle_get_i (reject), 7, "value accepted after a rejection");
+
+	// a setter changing another variable updates handles on that one
+	r_config_set_i (cfg, "test.chain", 21);
+	mu_assert_eq ((int)r_config_handle_get_i (derived), 42, "variable set from a callback");
+
+	r_config_handle_free (clamp);
+	r_config_handle_free (reject);
+	r_config_handle_free (derived);
+	r_config_free (cfg);
+	mu_end;
+}
+
+bool test_r_config_handle_lock(void) {
+	RConfig *cfg = r_config_new (NULL);
+	r_config_set_i (cfg, "scr.columns", 80);
+	// a handle can be taken before the variable exists
+	RConfigHandle *later = r_config_handle_new (cfg, "scr.later");
+	RConfigHandle *never = r_config_handle_new (cfg, "scr.never");
+	RConfigHandle *cols = r_config_handle_new (cfg, "scr.columns");
+	mu_assert_eq ((int)r_config_handle_get_i (later), 0, "missing variable reads as zero");
+	r_config_set_i (cfg, "scr.later", 5);
+	mu_assert_eq ((int)r_config_handle_get_i (later), 5, "variable created after the handle");
+
+	// once locked new variables cannot appear, existing ones still change
+	r_config_lock (cfg, 1);
+	r_config_set_i (cfg, "scr.never", 9);
+	mu_assert_eq ((int)r_config_handle_get_i (never), 0, "locked config does not grow");
+	mu_assert ("locked config has no new node", !r_config_node_get (cfg, "scr.never"));
+	r_config_set_i (cfg, "scr.columns", 120);
+	mu_assert_eq ((int)r_config_handle_get_i (cols), 120, "locked config still updates");
+	r_config_lock (cfg, 0);
+	r_config_set_i (cfg, "scr.never", 9);
+	mu_assert_eq ((int)r_config_handle_get_i (never), 9, "unlocked config grows again");
+
+	// read only variables keep their value
+	r_config_readonly (cfg, "scr.columns");
+	r_config_set_i (cfg, "scr.columns", 40);
+	mu_assert_eq ((int)r_config_handle_get_i (cols), 120, "read only variable");
+
+	r_config_handle_free (later);
+	r_config_handle_free (never);
+	r_config_handle_free (cols);
+	r_config_free (cfg);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_config_get_set);
+	mu_run_test(test_r_config_handle);
+	mu_run_test(test_r_config_handle_callbacks);
+	mu_run_test(test_r_config_handle_lock);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -18,9 +18,62 @@ bool test_r_debruijn_offset(void) {
 	mu_end;
 }
 
+// The default charset has 62 symbols and patterns are built from every
+// 3 symbol word once, so this is the longest pattern without repeats.
+#define DEBRUIJN_MAX (62 * 62 * 62)
+
+bool test_r_debruijn_offset_all(void) {
+	char *pattern = r_debruijn_pattern (DEBRUIJN_MAX, 0, NULL);
+	int off, bad4 = 0, bad8 = 0;
+	mu_assert_eq ((int)strlen (pattern), DEBRUIJN_MAX, "maximum pattern length");
+	// every offset must be found from a 4 and an 8 byte value read in
+	// either endianness, without building the pattern again
+	for (off = 0; off + 8 <= DEBRUIJN_MAX; off++) {
+		const ut8 *p = (const ut8 *)pattern + off;
+		if (r_debruijn_offset (r_read_le32 (p), false) != off ||
+				r_debruijn_offset (r_read_be32 (p), true) != off) {
+			bad4++;
+		}
+		if (r_debruijn_offset (r_read_le64 (p), false) != off ||
+				r_debruijn_offset (r_read_be64 (p), true) != off) {
+			bad8++;
+		}
+	}
+	mu_assert_eq (bad4, 0, "offsets of 4 byte values");
+	mu_assert_eq (bad8, 0, "offsets of 8 byte values");
+	// the last 4 byte words that do not fit an 8 byte read
+	for (; off + 4 <= DEBRUIJN_MAX; off++) {
+		const ut8 *p = (const ut8 *)pattern + off;
+		mu_assert_eq (r_debruijn_offset (r_read_le32 (p), false), off, "tail offset - little endian");
+		mu_assert_eq (r_debruijn_offset (r_read_be32 (p), true), off, "tail offset - big endian");
+	}
+	free (pattern);
+	mu_end;
+}
+
+bool test_r_debruijn_offset_large(void) {
+	mu_assert_eq (r_debruijn_offset (0x474e5847, false), 0x10000, "offset 0x10000 - little endian");
+	mu_assert_eq (r_debruijn_offset (0x756c4f74, false), 0x20000, "offset 0x20000 - little endian");
+	mu_assert_eq (r_debruijn_offset (0x744f6c75, true), 0x20000, "offset 0x20000 - big endian");
+	mu_assert_eq (r_debruijn_offset (0x4f766c4f756c4f74ULL, false), 0x20000, "64 bit offset 0x20000");
+	mu_assert_eq (r_debruijn_offset (0x30303039, false), DEBRUIJN_MAX - 4, "last offset");
+	mu_end;
+}
+
+bool test_r_debruijn_offset_missing(void) {
+	// 'AAA' only appears once, followed by 'B'
+	mu_assert_eq (r_debruijn_offset (0x41414141, false), -1, "AAAA is not in the pattern");
+	mu_assert_eq (r_debruijn_offset (0x12345678, false), -1, "bytes outside the charset");
+	mu_assert_eq (r_debruijn_offset (0x4141424141414141ULL, false), -1, "64 bit value not in the pattern");
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_r_debruijn_pattern);
 	mu_run_test(test_r_debruijn_offset);
+	mu_run_test(test_r_debruijn_offset_all);
+	mu_run_test(test_r_debruijn_offset_large);
+	mu_run_test(test_r_debruijn_offset_missing);
 	return tests_passed != tests_run;
 }
 
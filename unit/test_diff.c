@@ -102,8 +102,166 @@ bool test_r_diff_buffers_distance(void) {
 	mu_end;
 }
 
+// plain two-row dynamic programming, the reference for every fast path
+static ut32 ref_levenstein(const ut8 *a, int la, const ut8 *b, int lb) {
+	ut32 *prev = malloc ((lb + 1) * sizeof (ut32));
+	ut32 *cur = malloc ((lb + 1) * sizeof (ut32));
+	ut32 *tmp, res;
+	int i, j;
+	for (j = 0; j <= lb; j++) {
+		prev[j] = j;
+	}
+	for (i = 1; i <= la; i++) {
+		cur[0] = i;
+		for (j = 1; j <= lb; j++) {
+			ut32 sub = prev[j - 1] + (a[i - 1] != b[j - 1]);
+			ut32 del = prev[j] + 1;
+			ut32 ins = cur[j - 1] + 1;
+			cur[j] = R_MIN (sub, R_MIN (del, ins));
+		}
+		tmp = prev;
+		prev = cur;
+		cur = tmp;
+	}
+	res = prev[lb];
+	free (prev);
+	free (cur);
+	return res;
+}
+
+// b is a copy of a with some random substitutions, insertions and deletions
+static int mutate(const ut8 *a, int la, ut8 *b, int edits, int alphabet) {
+	int i = 0, lb = 0;
+	while (i < la) {
+		if (edits > 0 && rand () % (la / edits + 1) == 0) {
+			switch (rand () % 3) {
+			case 0: b[lb++] = rand () % alphabet; i++; break;
+			case 1: b[lb++] = rand () % alphabet; break;
+			case 2: i++; break;
+			}
+		} else {
+			b[lb++] = a[i++];
+		}
+	}
+	return lb;
+}
+
+bool test_r_diff_distance_random(void) {
+	int lens[] = { 1, 2, 7, 31, 63, 64, 65, 127, 128, 129, 255, 256, 1000, 4097 };
+	int nlens = sizeof (lens) / sizeof (lens[0]);
+	ut8 *a = malloc (8192), *b = malloc (8192);
+	char msg[128];
+	int i, j, k;
+
+	srand (0xd1ff);
+	for (i = 0; i < nlens; i++) {
+		for (k = 0; k < 8; k++) {
+			// small alphabets make many equal bytes, large ones few
+			int alphabet = k & 1? 4: 256;
+			int la = lens[i];
+			int lb;
+			for (j = 0; j < la; j++) {
+				a[j] = rand () % alphabet;
+			}
+			if (k < 4) {
+				lb = mutate (a, la, b, 1 + la / 10, alphabet);
+			} else {
+				lb = lens[(i + k) % nlens];
+				for (j = 0; j < lb; j++) {
+					b[j] = rand () % alphabet;
+				}
+			}
+			if (!lb) {
+				continue;
+			}
+			ut32 exp = ref_levenstein (a, la, b, lb);
+			ut32 d1 = 0xdeadbeef, d2 = 0xdeadbeef;
+			RDiff *d = r_diff_new ();
+			d->levenstein = true;
+			snprintf (msg, sizeof (msg), "distance %d/%d len %d/%d", i, k, la, lb);
+			mu_assert (msg, r_diff_buffers_distance (d, a, la, b, lb, &d1, NULL));
+			mu_assert_eq (d1, exp, msg);
+			snprintf (msg, sizeof (msg), "swapped distance %d/%d len %d/%d", i, k, la, lb);
+			mu_assert (msg, r_diff_buffers_distance (d, b, lb, a, la, &d2, NULL));
+			mu_assert_eq (d2, exp, msg);
+			r_diff_free (d);
+		}
+	}
+	free (a);
+	free (b);
+	mu_end;
+}
+
+bool test_r_diff_distance_cutoff(void) {
+	ut8 *a = malloc (2048), *b = malloc (2048);
+	char msg[128];
+	int i, j;
+
+	srand (0xc07);
+	for (i = 0; i < 200; i++) {
+		int la = 1 + rand () % 1024;
+		for (j = 0; j < la; j++) {
+			a[j] = rand ();
+		}
+		int lb = mutate (a, la, b, rand () % 64, 256);
+		if (!lb) {
+			continue;
+		}
+		ut32 exp = ref_levenstein (a, la, b, lb);
+		ut32 cutoff = rand () % 64;
+		ut32 dist = 0xdeadbeef;
+		RDiff *d = r_diff_new ();
+		d->levenstein = true;
+		bool within = r_diff_buffers_distance_cutoff (d, a, la, b, lb, cutoff, &dist);
+		snprintf (msg, sizeof (msg), "cutoff %d: distance %d, cutoff %d", i, exp, cutoff);
+		mu_assert_eq (within, exp <= cutoff, msg);
+		if (within) {
+			mu_assert_eq (dist, exp, msg);
+		}
+		r_diff_free (d);
+	}
+	free (a);
+	free (b);
+	mu_end;
+}
+
+#define BIG (1024 * 1024)
+
+bool test_r_diff_distance_big(void) {
+	ut8 *a = malloc (BIG), *b = malloc (BIG + 64);
+	ut32 dist = 0;
+	int i;
+
+	srand (0xb16);
+	for (i = 0; i < BIG; i++) {
+		a[i] = rand ();
+	}
+	// 32 substitutions and 32 insertions far apart from each other
+	memcpy (b, a, BIG);
+	for (i = 0; i < 32; i++) {
+		b[i * (BIG / 32) + 7] = ~a[i * (BIG / 32) + 7];
+	}
+	for (i = 0; i < 32; i++) {
+		int off = i * (BIG / 32) + 1000 + i;
+		memmove (b + off + 1, b + off, BIG + i - off);
+		b[off] = 'X';
+	}
+	RDiff *d = r_diff_new ();
+	d->levenstein = true;
+	mu_assert ("1MB within cutoff", r_diff_buffers_distance_cutoff (d, a, BIG, b, BIG + 32, 128, &dist));
+	mu_assert_eq (dist, 64, "1MB distance");
+	mu_assert ("1MB over cutoff", !r_diff_buffers_distance_cutoff (d, a, BIG, b, BIG + 32, 63, &dist));
+	r_diff_free (d);
+	free (a);
+	free (b);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_r_diff_buffers_distance);
+	mu_run_test(test_r_diff_distance_random);
+	mu_run_test(test_r_diff_distance_cutoff);
+	mu_run_test(test_r_diff_distance_big);
 	return tests_passed != tests_run;
 }
 
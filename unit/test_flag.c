@@ -0,0 +1,149 @@
+#include <r_flags.h>
+#include "minunit.h"
+
+bool test_r_flag_set_get(void) {
+	RFlag *flags = r_flag_new ();
+	RFlagItem *fi;
+	// from legacy_unit/flags/test.c
+	r_flag_set (flags, "foo", 1024, 50);
+	fi = r_flag_get_i (flags, 1024);
+	mu_assert ("flag found by address", fi && !strcmp (fi->name, "foo"));
+	// setting an existing name moves the flag
+	r_flag_set (flags, "foo", 300, 0);
+	mu_assert ("old address is free", !r_flag_get_i (flags, 1024));
+	fi = r_flag_get (flags, "foo");
+	mu_assert ("flag found by name", fi != NULL);
+	mu_assert_eq ((int)fi->offset, 300, "moved flag offset");
+	mu_assert ("flag found at new address", r_flag_get_i (flags, 300) == fi);
+	mu_assert_eq (r_flag_count (flags, NULL), 1, "one flag");
+	r_flag_free (flags);
+	mu_end;
+}
+
+bool test_r_flag_get_at(void) {
+	RFlag *flags = r_flag_new ();
+	RFlagItem *fi;
+	r_flag_set (flags, "sym.b", 0x2000, 16);
+	r_flag_set (flags, "sym.a", 0x1000, 16);
+	r_flag_set (flags, "sym.c", 0x3000, 16);
+	mu_assert ("nothing before the first flag", !r_flag_get_at (flags, 0xfff, true));
+	fi = r_flag_get_at (flags, 0x1fff, true);
+	mu_assert ("closest flag before", fi && !strcmp (fi->name, "sym.a"));
+	fi = r_flag_get_at (flags, 0x2000, true);
+	mu_assert ("flag at the address", fi && !strcmp (fi->name, "sym.b"));
+	fi = r_flag_get_at (flags, UT64_MAX, true);
+	mu_assert ("closest flag to the end", fi && !strcmp (fi->name, "sym.c"));
+	mu_assert ("no exact flag", !r_flag_get_at (flags, 0x2001, false));
+
+	// several flags on one address are all reachable
+	r_flag_set (flags, "fcn.b", 0x2000, 16);
+	mu_assert_eq (r_list_length (r_flag_get_list (flags, 0x2000)), 2, "flags at one address");
+	r_flag_unset_name (flags, "sym.b");
+	fi = r_flag_get_at (flags, 0x2010, true);
+	mu_assert ("other flag remains", fi && !strcmp (fi->name, "fcn.b"));
+	r_flag_unset_name (flags, "fcn.b");
+	fi = r_flag_get_at (flags, 0x2010, true);
+	mu_assert ("deleted flags are skipped", fi && !strcmp (fi->name, "sym.a"));
+	r_flag_unset_off (flags, 0x1000);
+	mu_assert ("deleted by address", !r_flag_get_at (flags, 0x2010, true));
+	r_flag_free (flags);
+	mu_end;
+}
+
+#define NFLAGS 5000000
+#define BASE 0x400000ULL
+
+// rand () may only give 15 bits
+static int rnd(int n) {
+	return (int)((((ut32)rand () << 16) ^ (ut32)rand ()) % n);
+}
+
+bool test_r_flag_stress(void) {
+	RFlag *flags = r_flag_new ();
+	char *namebuf = malloc (NFLAGS * 16);
+	const char **names = malloc (NFLAGS * sizeof (char *));
+	ut64 *addrs = malloc (NFLAGS * sizeof (ut64));
+	ut32 *sizes = malloc (NFLAGS * sizeof (ut32));
+	int *order = malloc (NFLAGS * sizeof (int));
+	int i, bad = 0;
+	char name[32];
+
+	// symbols arrive in no particular order when loading a binary
+	for (i = 0; i < NFLAGS; i++) {
+		order[i] = i;
+	}
+	srand (1337);
+	for (i = NFLAGS - 1; i > 0; i--) {
+		int j = rnd (i + 1);
+		int t = order[i];
+		order[i] = order[j];
+		order[j] = t;
+	}
+	for (i = 0; i < NFLAGS; i++) {
+		int k = order[i];
+		names[i] = namebuf + i * 16;
+		snprintf (namebuf + i * 16, 16, "sym.%d", k);
+		addrs[i] = BASE + (ut64)k * 16;
+		sizes[i] = 16;
+	}
+	// half in one bulk insert, half one by one
+	mu_assert_eq (r_flag_set_many (flags, names, addrs, sizes, NFLAGS / 2), NFLAGS / 2, "bulk insert");
+	for (i = NFLAGS / 2; i < NFLAGS; i++) {
+		r_flag_set (flags, names[i], addrs[i], sizes[i]);
+	}
+	mu_assert_eq (r_flag_count (flags, NULL), NFLAGS, "flag count");
+
+	for (i = 0; i < NFLAGS; i++) {
+		RFlagItem *fi = r_flag_get (flags, names[i]);
+		if (!fi || fi->offset != addrs[i]) {
+			bad++;
+		}
+	}
+	mu_assert_eq (bad, 0, "every flag found by name");
+	for (i = 0; i < 100000; i++) {
+		int k = rnd (NFLAGS);
+		RFlagItem *fi = r_flag_get_at (flags, BASE + (ut64)k * 16 + rand () % 16, true);
+		snprintf (name, sizeof (name), "sym.%d", k);
+		if (!fi || strcmp (fi->name, name)) {
+			bad++;
+		}
+	}
+	mu_assert_eq (bad, 0, "closest flag at random addresses");
+
+	// drop the even symbols, lookups land on the previous odd one
+	for (i = 0; i < NFLAGS; i += 2) {
+		snprintf (name, sizeof (name), "sym.%d", i);
+		r_flag_unset_name (flags, name);
+	}
+	mu_assert_eq (r_flag_count (flags, NULL), NFLAGS / 2, "count after deleting half");
+	for (i = 2; i < NFLAGS; i += 2 * 997) {
+		RFlagItem *fi = r_flag_get_at (flags, BASE + (ut64)i * 16, true);
+		snprintf (name, sizeof (name), "sym.%d", i - 1);
+		if (!fi || strcmp (fi->name, name)) {
+			bad++;
+		}
+	}
+	mu_assert_eq (bad, 0, "closest flag skips deleted ones");
+	r_flag_unset_all (flags);
+	mu_assert_eq (r_flag_count (flags, NULL), 0, "no flags left");
+	mu_assert ("empty address index", !r_flag_get_at (flags, UT64_MAX, true));
+
+	r_flag_free (flags);
+	free (namebuf);
+	free (names);
+	free (addrs);
+	free (sizes);
+	free (order);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_flag_set_get);
+	mu_run_test(test_r_flag_get_at);
+	mu_run_test(test_r_flag_stress);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -0,0 +1,301 @@
+#include <r_util.h>
+#include "minunit.h"
+
+static void topo_sorting(RGraphNode *n, RGraphVisitor *vis) {
+	RList *order = (RList *)vis->data;
+	r_list_prepend (order, n);
+}
+
+#define check_list(act, exp, descr) do { \
+		RListIter *ita = r_list_iterator (act); \
+		RListIter *ite = r_list_iterator (exp); \
+		while (r_list_iter_next (ita) && r_list_iter_next (ite)) { \
+			int a = (int)(intptr_t)r_list_iter_get (ita); \
+			int e = (int)(intptr_t)r_list_iter_get (ite); \
+			mu_assert_eq (a, e, descr); \
+		} \
+		mu_assert ("lists must have same elements", (!ita && !ite)); \
+	} while (0)
+
+// labels of the nodes in a CSR index array, for comparing with literals
+#define check_labels(csr, order, n, exp, descr) do { \
+		int _i; \
+		for (_i = 0; _i < (n); _i++) { \
+			int _l = (int)(intptr_t)r_graph_csr_node ((csr), (order)[_i])->data; \
+			mu_assert_eq (_l, (exp)[_i], descr); \
+		} \
+	} while (0)
+
+static RGraphNode *gn[11];
+
+// the graph from legacy_unit/util/test_graph.c, a DAG rooted at 1
+static RGraph *build_graph(void) {
+	RGraph *g = r_graph_new ();
+	int i;
+	for (i = 1; i <= 10; i++) {
+		gn[i] = r_graph_add_node (g, (void *)(intptr_t)i);
+	}
+	r_graph_add_edge (g, gn[1], gn[2]);
+	r_graph_add_edge (g, gn[1], gn[3]);
+	r_graph_add_edge (g, gn[2], gn[3]);
+	r_graph_add_edge (g, gn[2], gn[4]);
+	r_graph_add_edge (g, gn[2], gn[5]);
+	r_graph_add_edge (g, gn[3], gn[5]);
+	r_graph_add_edge (g, gn[5], gn[7]);
+	r_graph_add_edge (g, gn[7], gn[9]);
+	r_graph_add_edge (g, gn[9], gn[10]);
+	r_graph_add_edge (g, gn[4], gn[6]);
+	r_graph_add_edge (g, gn[6], gn[8]);
+	r_graph_add_edge (g, gn[6], gn[9]);
+	r_graph_add_edge (g, gn[8], gn[10]);
+	r_graph_add_edge (g, gn[5], gn[4]);
+	r_graph_add_edge (g, gn[6], gn[7]);
+	r_graph_add_edge (g, gn[7], gn[8]);
+	r_graph_add_edge (g, gn[8], gn[9]);
+	return g;
+}
+
+bool test_r_graph(void) {
+	RGraph *g = r_graph_new ();
+
+	mu_assert_eq (g->n_nodes, 0, "n_nodes.start");
+	r_graph_add_node (g, (void *)1);
+	mu_assert_eq (g->n_nodes, 1, "n_nodes.insert");
+	r_graph_reset (g);
+	mu_assert_eq (g->n_nodes, 0, "n_nodes.reset");
+
+	RGraphNode *n1 = r_graph_add_node (g, (void *)1);
+	mu_assert ("get_node.1", r_graph_get_node (g, n1->idx) == n1);
+	RGraphNode *n2 = r_graph_add_node (g, (void *)2);
+	mu_assert ("get_node.2", r_graph_get_node (g, n2->idx) == n2);
+	r_graph_add_edge (g, n1, n2);
+	mu_assert ("is_adjacent.1", r_graph_adjacent (g, n1, n2));
+	RList *exp_neigh = r_list_new ();
+	r_list_append (exp_neigh, n2);
+	check_list (r_graph_get_neighbours (g, n1), exp_neigh, "get_neighbours.1");
+	RGraphNode *n3 = r_graph_add_node (g, (void *)3);
+	r_graph_add_edge (g, n1, n3);
+	r_list_append (exp_neigh, n3);
+	check_list (r_graph_get_neighbours (g, n1), exp_neigh, "get_neighbours.2");
+	r_list_free (exp_neigh);
+	r_graph_free (g);
+
+	g = build_graph ();
+	mu_assert_eq (g->n_nodes, 10, "n_nodes");
+	RList *exp_nodes = r_list_new ();
+	int i;
+	for (i = 1; i <= 10; i++) {
+		r_list_append (exp_nodes, gn[i]);
+	}
+	check_list (r_graph_get_nodes (g), exp_nodes, "get_all_nodes");
+	r_list_free (exp_nodes);
+	mu_assert_eq (g->n_edges, 17, "n_edges");
+	r_graph_del_edge (g, gn[8], gn[9]);
+	mu_assert ("is_adjacent.0", !r_graph_adjacent (g, gn[8], gn[9]));
+	mu_assert_eq (g->n_edges, 16, "n_edges.del");
+	r_graph_add_edge (g, gn[9], gn[8]);
+	mu_assert ("is_adjacent.reverse", r_graph_adjacent (g, gn[9], gn[8]));
+	r_graph_del_edge (g, gn[9], gn[8]);
+	r_graph_add_edge (g, gn[8], gn[9]);
+	mu_assert ("is_adjacent.1", !r_graph_adjacent (g, gn[9], gn[8]));
+	mu_assert ("is_adjacent.2", r_graph_adjacent (g, gn[8], gn[9]));
+
+	RGraphVisitor vis = { 0 };
+	vis.data = r_list_new ();
+	vis.finish_node = (RGraphNodeCallback)topo_sorting;
+	r_graph_dfs_node (g, gn[1], &vis);
+	RList *exp_order = r_list_new ();
+	int topo[] = { 1, 2, 3, 5, 4, 6, 7, 8, 9, 10 };
+	for (i = 0; i < 10; i++) {
+		r_list_append (exp_order, gn[topo[i]]);
+	}
+	check_list ((RList *)vis.data, exp_order, "topo_order");
+	r_list_free (exp_order);
+	r_list_free ((RList *)vis.data);
+
+	RList *exp_innodes = r_list_new ();
+	r_list_append (exp_innodes, gn[1]);
+	r_list_append (exp_innodes, gn[2]);
+	check_list (r_graph_innodes (g, gn[3]), exp_innodes, "in_nodes");
+	r_list_free (exp_innodes);
+	RList *exp_allnodes = r_list_new ();
+	r_list_append (exp_allnodes, gn[1]);
+	r_list_append (exp_allnodes, gn[2]);
+	r_list_append (exp_allnodes, gn[5]);
+	check_list (r_graph_all_neighbours (g, gn[3]), exp_allnodes, "in/out_nodes");
+	r_list_free (exp_allnodes);
+
+	r_graph_del_node (g, gn[1]);
+	r_graph_del_node (g, gn[2]);
+	mu_assert_eq (g->n_nodes, 8, "n_nodes.del_node");
+	mu_assert_eq (g->n_edges, 12, "n_edges.del_node");
+	r_graph_free (g);
+	mu_end;
+}
+
+bool test_r_graph_csr(void) {
+	RGraph *g = build_graph ();
+	RGraphCSR *csr = r_graph_csr_new (g);
+	int order[10], idom[10], comp[10];
+	int exp_dfs[] = { 1, 2, 3, 5, 7, 9, 10, 8, 4, 6 };
+	int exp_bfs[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	int exp_topo[] = { 1, 2, 3, 5, 4, 6, 7, 8, 9, 10 };
+	int exp_idom[] = { 0, 1, 1, 1, 1, 1, 4, 1, 1, 1, 1 };
+	int i, root;
+
+	mu_assert ("csr snapshot", csr != NULL);
+	mu_assert_eq (csr->n_nodes, 10, "csr n_nodes");
+	mu_assert_eq (csr->n_edges, 17, "csr n_edges");
+	root = r_graph_csr_index (csr, gn[1]);
+
+	// the snapshot does not follow later changes to the graph
+	r_graph_add_edge (g, gn[10], gn[1]);
+	mu_assert_eq (csr->n_edges, 17, "csr is immutable");
+
+	mu_assert_eq (r_graph_csr_dfs (csr, root, order), 10, "csr dfs count");
+	check_labels (csr, order, 10, exp_dfs, "csr dfs preorder");
+	mu_assert_eq (r_graph_csr_bfs (csr, root, order), 10, "csr bfs count");
+	check_labels (csr, order, 10, exp_bfs, "csr bfs order");
+	mu_assert ("csr topo on a dag", r_graph_csr_topo (csr, order));
+	check_labels (csr, order, 10, exp_topo, "csr topo order matches dfs finish order");
+
+	r_graph_csr_dominators (csr, root, idom);
+	mu_assert_eq (idom[root], root, "root dominates itself");
+	for (i = 2; i <= 10; i++) {
+		int v = r_graph_csr_index (csr, gn[i]);
+		int d = (int)(intptr_t)r_graph_csr_node (csr, idom[v])->data;
+		mu_assert_eq (d, exp_idom[i], "immediate dominator");
+	}
+	mu_assert_eq (r_graph_csr_scc (csr, comp), 10, "a dag has one scc per node");
+	r_graph_csr_free (csr);
+
+	// with 10 -> 1 every node is on a cycle through the root
+	csr = r_graph_csr_new (g);
+	mu_assert ("csr topo on a cyclic graph", !r_graph_csr_topo (csr, order));
+	mu_assert_eq (r_graph_csr_scc (csr, comp), 1, "single scc");
+	r_graph_csr_free (csr);
+	r_graph_free (g);
+	mu_end;
+}
+
+#define RN 120
+
+static bool reachable(ut8 adj[RN][RN], int from, int to, int skip) {
+	int stack[RN], sp = 0, u, v;
+	ut8 seen[RN] = {0};
+	if (from == skip) {
+		return false;
+	}
+	stack[sp++] = from;
+	seen[from] = 1;
+	while (sp) {
+		u = stack[--sp];
+		if (u == to) {
+			return true;
+		}
+		for (v = 0; v < RN; v++) {
+			if (adj[u][v] && !seen[v] && v != skip) {
+				seen[v] = 1;
+				stack[sp++] = v;
+			}
+		}
+	}
+	return false;
+}
+
+bool test_r_graph_csr_random(void) {
+	static ut8 adj[RN][RN];
+	int order[RN], pos[RN], idom[RN], comp[RN];
+	RGraphNode *nodes[RN];
+	int round, i, j, u, v;
+
+	srand (0x9a4);
+	for (round = 0; round < 20; round++) {
+		// even rounds only add forward edges so the graph is a DAG,
+		// odd ones always get at least the 1 <-> 2 cycle
+		bool dag = !(round & 1);
+		RGraph *g = r_graph_new ();
+		memset (adj, 0, sizeof (adj));
+		for (i = 0; i < RN; i++) {
+			nodes[i] = r_graph_add_node (g, (void *)(intptr_t)i);
+		}
+		for (i = 0; i < RN * 3; i++) {
+			u = rand () % RN;
+			v = rand () % RN;
+			if (dag && u >= v) {
+				continue;
+			}
+			if (u != v && !adj[u][v]) {
+				adj[u][v] = 1;
+				r_graph_add_edge (g, nodes[u], nodes[v]);
+			}
+		}
+		for (i = 1; !dag && i <= 2; i++) {
+			if (!adj[i][3 - i]) {
+				adj[i][3 - i] = 1;
+				r_graph_add_edge (g, nodes[i], nodes[3 - i]);
+			}
+		}
+		RGraphCSR *csr = r_graph_csr_new (g);
+		int root = r_graph_csr_index (csr, nodes[0]);
+		int n = 0;
+
+		for (i = 0; i < RN; i++) {
+			n += reachable (adj, 0, i, -1);
+		}
+		mu_assert_eq (r_graph_csr_dfs (csr, root, order), n, "random dfs reach");
+		mu_assert_eq (r_graph_csr_bfs (csr, root, order), n, "random bfs reach");
+		mu_assert_eq (r_graph_csr_topo (csr, order), dag, "random topo detects cycles");
+		if (dag) {
+			for (i = 0; i < RN; i++) {
+				pos[(int)(intptr_t)r_graph_csr_node (csr, order[i])->data] = i;
+			}
+			for (u = 0; u < RN; u++) {
+				for (v = 0; v < RN; v++) {
+					mu_assert ("random topo order", !adj[u][v] || pos[u] < pos[v]);
+				}
+			}
+		}
+
+		r_graph_csr_dominators (csr, root, idom);
+		for (i = 1; i < RN; i++) {
+			v = r_graph_csr_index (csr, nodes[i]);
+			if (!reachable (adj, 0, i, -1)) {
+				mu_assert_eq (idom[v], -1, "unreachable node has no dominator");
+				continue;
+			}
+			int d = (int)(intptr_t)r_graph_csr_node (csr, idom[v])->data;
+			mu_assert ("idom dominates", d == 0 || !reachable (adj, 0, i, d));
+			// every other strict dominator of i also dominates idom(i)
+			for (j = 1; j < RN; j++) {
+				if (j != i && j != d && !reachable (adj, 0, i, j)) {
+					mu_assert ("idom is the closest dominator", !reachable (adj, 0, d, j));
+				}
+			}
+		}
+
+		r_graph_csr_scc (csr, comp);
+		for (u = 0; u < RN; u += 7) {
+			for (v = 0; v < RN; v += 5) {
+				int cu = comp[r_graph_csr_index (csr, nodes[u])];
+				int cv = comp[r_graph_csr_index (csr, nodes[v])];
+				bool same = reachable (adj, u, v, -1) && reachable (adj, v, u, -1);
+				mu_assert_eq (cu == cv, same, "random scc");
+			}
+		}
+		r_graph_csr_free (csr);
+		r_graph_free (g);
+	}
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_graph);
+	mu_run_test(test_r_graph_csr);
+	mu_run_test(test_r_graph_csr_random);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -0,0 +1,106 @@
+#include <r_hash.h>
+#include "minunit.h"
+
+static const ut64 algos[] = {
+	R_HASH_MD5, R_HASH_SHA1, R_HASH_SHA256, R_HASH_SHA384, R_HASH_SHA512,
+	R_HASH_MD4, R_HASH_XXHASH, R_HASH_ADLER32, R_HASH_CRC32,
+};
+#define NALGOS (sizeof (algos) / sizeof (algos[0]))
+
+// digest of buf computed one algorithm at a time, the way rahash2 used to
+static int reference(ut64 algo, const ut8 *buf, int len, ut8 *out) {
+	RHash *h = r_hash_new (true, algo);
+	int n = r_hash_calculate (h, algo, buf, len);
+	memcpy (out, h->digest, n);
+	r_hash_free (h);
+	return n;
+}
+
+static bool check_stream(const ut8 *buf, int len, int threads, int chunk, char *msg, int msglen) {
+	ut64 all = 0;
+	int i, off, dlen;
+	for (i = 0; i < NALGOS; i++) {
+		all |= algos[i];
+	}
+	RHashStream *hs = r_hash_stream_new (all, threads);
+	if (!hs) {
+		snprintf (msg, msglen, "stream allocation");
+		return false;
+	}
+	for (off = 0; off < len; off += chunk) {
+		r_hash_stream_update (hs, buf + off, R_MIN (chunk, len - off));
+	}
+	r_hash_stream_end (hs);
+	for (i = 0; i < NALGOS; i++) {
+		ut8 exp[R_HASH_SIZE_SHA512];
+		int n = reference (algos[i], buf, len, exp);
+		const ut8 *got = r_hash_stream_digest (hs, algos[i], &dlen);
+		if (!got || dlen != n || memcmp (got, exp, n)) {
+			snprintf (msg, msglen, "%s differs for len %d, %d threads, chunk %d",
+				r_hash_name (algos[i]), len, threads, chunk);
+			r_hash_stream_free (hs);
+			return false;
+		}
+	}
+	r_hash_stream_free (hs);
+	return true;
+}
+
+bool test_r_hash_stream_known(void) {
+	RHashStream *hs = r_hash_stream_new (R_HASH_MD5 | R_HASH_SHA1, 0);
+	int len = 0;
+	char *hex;
+	r_hash_stream_update (hs, (const ut8 *)"hello", 5);
+	r_hash_stream_update (hs, (const ut8 *)"world", 5);
+	r_hash_stream_end (hs);
+	const ut8 *d = r_hash_stream_digest (hs, R_HASH_MD5, &len);
+	mu_assert_eq (len, R_HASH_SIZE_MD5, "md5 digest size");
+	hex = r_hex_bin2strdup (d, len);
+	mu_assert_streq (hex, "fc5e038d38a57032085441e7fe7010b0", "md5 of helloworld");
+	free (hex);
+	d = r_hash_stream_digest (hs, R_HASH_SHA1, &len);
+	hex = r_hex_bin2strdup (d, len);
+	mu_assert_streq (hex, "6adfb183a4a2c94a2f92dab5ade762a47889a5a1", "sha1 of helloworld");
+	free (hex);
+	mu_assert ("algorithm not requested", !r_hash_stream_digest (hs, R_HASH_SHA256, &len));
+	r_hash_stream_free (hs);
+	mu_end;
+}
+
+bool test_r_hash_stream_random(void) {
+	int lens[] = { 0, 1, 55, 56, 63, 64, 65, 111, 112, 127, 128, 129, 4096, 100003, 1 << 20 };
+	int chunks[] = { 1, 7, 64, 4095, 1 << 16, 1 << 20 };
+	int threads[] = { 0, 1, 4 };
+	ut8 *buf = malloc (1 << 20);
+	char msg[256];
+	int i, c, t;
+
+	srand (0x5a5a);
+	for (i = 0; i < (1 << 20); i++) {
+		buf[i] = rand ();
+	}
+	for (i = 0; i < sizeof (lens) / sizeof (lens[0]); i++) {
+		for (c = 0; c < sizeof (chunks) / sizeof (chunks[0]); c++) {
+			// byte at a time over a megabyte is too slow to be useful
+			if (chunks[c] == 1 && lens[i] > 4096) {
+				continue;
+			}
+			for (t = 0; t < sizeof (threads) / sizeof (threads[0]); t++) {
+				bool ok = check_stream (buf, lens[i], threads[t], chunks[c], msg, sizeof (msg));
+				mu_assert (msg, ok);
+			}
+		}
+	}
+	free (buf);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_hash_stream_known);
+	mu_run_test(test_r_hash_stream_random);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -0,0 +1,118 @@
+#include <r_util.h>
+#include <r_th.h>
+#include "minunit.h"
+
+bool test_r_mem_arena_alloc(void) {
+	RMemArena *a = r_mem_arena_new (4096);
+	int i;
+	mu_assert ("arena allocation", a != NULL);
+	for (i = 1; i < 2000; i++) {
+		ut8 *p = r_mem_arena_alloc (a, i % 97 + 1);
+		mu_assert ("alloc", p != NULL);
+		mu_assert_eq ((int)((size_t)p % sizeof (void *)), 0, "pointer alignment");
+		memset (p, i, i % 97 + 1);
+	}
+	mu_assert ("used bytes", r_mem_arena_used (a) >= 2000);
+
+	// bigger than a block still works and is zeroed with calloc
+	ut8 *big = r_mem_arena_calloc (a, 1, 3 * 4096);
+	mu_assert ("oversized alloc", big != NULL);
+	for (i = 0; i < 3 * 4096; i++) {
+		if (big[i]) {
+			break;
+		}
+	}
+	mu_assert_eq (i, 3 * 4096, "calloc zeroes memory");
+
+	char *s = r_mem_arena_strdup (a, "eax");
+	mu_assert_streq (s, "eax", "strdup");
+	mu_assert ("alloc of size zero", r_mem_arena_alloc (a, 0) == NULL);
+	r_mem_arena_free (a);
+	mu_end;
+}
+
+bool test_r_mem_arena_mark_rewind(void) {
+	RMemArena *a = r_mem_arena_new (256);
+	r_mem_arena_alloc (a, 100);
+	RMemArenaMark m = r_mem_arena_mark (a);
+	size_t used = r_mem_arena_used (a);
+	void *first = r_mem_arena_alloc (a, 64);
+	int i;
+	// spill over several blocks after the mark
+	for (i = 0; i < 100; i++) {
+		r_mem_arena_alloc (a, 200);
+	}
+	r_mem_arena_rewind (a, m);
+	mu_assert ("used after rewind", r_mem_arena_used (a) == used);
+	mu_assert ("rewind reuses memory", r_mem_arena_alloc (a, 64) == first);
+
+	r_mem_arena_reset (a);
+	mu_assert ("used after reset", r_mem_arena_used (a) == 0);
+	mu_assert ("reset keeps the arena usable", r_mem_arena_alloc (a, 16) != NULL);
+	r_mem_arena_free (a);
+	mu_end;
+}
+
+#define THREADS 8
+
+typedef struct {
+	RMemArena *arena;
+	bool stable;
+	int *ready;
+} ThreadArena;
+
+static int grab_arena(RThread *th) {
+	ThreadArena *ta = th->user;
+	int i;
+	ta->arena = r_mem_arena_thread ();
+	ta->stable = true;
+	// no thread may exit and release its arena before every thread got
+	// one, or a later thread could be handed the same address
+	__sync_fetch_and_add (ta->ready, 1);
+	while (*(volatile int *)ta->ready < THREADS) {
+		r_sys_usleep (1000);
+	}
+	for (i = 0; i < 10000; i++) {
+		int *p = r_mem_arena_alloc (r_mem_arena_thread (), sizeof (int));
+		*p = i;
+		if (r_mem_arena_thread () != ta->arena) {
+			ta->stable = false;
+		}
+	}
+	r_mem_arena_reset (ta->arena);
+	return 0;
+}
+
+bool test_r_mem_arena_thread(void) {
+	RThread *th[THREADS];
+	ThreadArena ta[THREADS];
+	int i, j, ready = 0;
+	for (i = 0; i < THREADS; i++) {
+		ta[i].ready = &ready;
+		th[i] = r_th_new (grab_arena, &ta[i], 0);
+	}
+	for (i = 0; i < THREADS; i++) {
+		r_th_wait (th[i]);
+		r_th_free (th[i]);
+	}
+	for (i = 0; i < THREADS; i++) {
+		mu_assert ("thread arena", ta[i].arena != NULL);
+		mu_assert ("same arena within a thread", ta[i].stable);
+		for (j = i + 1; j < THREADS; j++) {
+			mu_assert ("distinct arena per thread", ta[i].arena != ta[j].arena);
+		}
+	}
+	mu_assert ("main thread arena", r_mem_arena_thread () != NULL);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_mem_arena_alloc);
+	mu_run_test(test_r_mem_arena_mark_rewind);
+	mu_run_test(test_r_mem_arena_thread);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -0,0 +1,185 @@
+#include <r_util.h>
+#include <r_th.h>
+#include "minunit.h"
+
+#define PRODUCERS 8
+#define CONSUMERS 8
+#define PER_PRODUCER 200000
+#define TOTAL (PRODUCERS * PER_PRODUCER)
+
+// Items are encoded as (producer << 24 | seq) + 1 so that NULL is never pushed.
+#define ITEM(p, s) ((void *)(intptr_t)((((p) << 24) | (s)) + 1))
+#define ITEM_PRODUCER(x) ((int)(((intptr_t)(x) - 1) >> 24))
+#define ITEM_SEQ(x) ((int)(((intptr_t)(x) - 1) & 0xffffff))
+
+typedef struct {
+	RMpmcQueue *q;
+	ut8 *seen;
+	int produced;
+	int consumed;
+	int duplicated;
+	int reordered;
+	int next_producer;
+} StressCtx;
+
+typedef struct {
+	StressCtx *ctx;
+	int id;
+} Worker;
+
+static int producer(RThread *th) {
+	Worker *w = th->user;
+	int i;
+	for (i = 0; i < PER_PRODUCER; i++) {
+		while (!r_mpmc_queue_push (w->ctx->q, ITEM (w->id, i))) {
+			r_sys_usleep (0);
+		}
+		__sync_fetch_and_add (&w->ctx->produced, 1);
+	}
+	return 0;
+}
+
+static int consumer(RThread *th) {
+	Worker *w = th->user;
+	StressCtx *ctx = w->ctx;
+	int last[PRODUCERS];
+	void *item;
+	int i;
+
+	for (i = 0; i < PRODUCERS; i++) {
+		last[i] = -1;
+	}
+	while (ctx->consumed < TOTAL) {
+		if (!r_mpmc_queue_pop (ctx->q, &item)) {
+			r_sys_usleep (0);
+			continue;
+		}
+		int p = ITEM_PRODUCER (item);
+		int s = ITEM_SEQ (item);
+		if (__sync_fetch_and_add (&ctx->seen[p * PER_PRODUCER + s], 1)) {
+			__sync_fetch_and_add (&ctx->duplicated, 1);
+		}
+		// a single consumer must see each producer's items in push order
+		if (s <= last[p]) {
+			__sync_fetch_and_add (&ctx->reordered, 1);
+		}
+		last[p] = s;
+		__sync_fetch_and_add (&ctx->consumed, 1);
+	}
+	return 0;
+}
+
+bool test_r_mpmc_queue_bounded(void) {
+	void *item = NULL;
+	int i;
+	RMpmcQueue *q = r_mpmc_queue_new (6);
+	mu_assert ("mpmc queue allocation", q != NULL);
+	// capacity is rounded up to the next power of two
+	mu_assert_eq (r_mpmc_queue_capacity (q), 8, "rounded capacity");
+	for (i = 0; i < 8; i++) {
+		mu_assert ("push to available slot", r_mpmc_queue_push (q, ITEM (0, i)));
+	}
+	mu_assert ("push to full queue must fail", !r_mpmc_queue_push (q, ITEM (0, 8)));
+	for (i = 0; i < 8; i++) {
+		mu_assert ("pop from non-empty queue", r_mpmc_queue_pop (q, &item));
+		mu_assert_eq (ITEM_SEQ (item), i, "fifo order");
+	}
+	mu_assert ("pop from empty queue must fail", !r_mpmc_queue_pop (q, &item));
+	r_mpmc_queue_free (q);
+	mu_end;
+}
+
+bool test_r_mpmc_queue_zero_size(void) {
+	RMpmcQueue *q = r_mpmc_queue_new (0);
+	mu_assert ("queue of size zero", q == NULL);
+	mu_end;
+}
+
+bool test_r_mpmc_queue_stress(void) {
+	RThread *th[PRODUCERS + CONSUMERS];
+	Worker w[PRODUCERS + CONSUMERS];
+	StressCtx ctx = { 0 };
+	int i, lost = 0;
+
+	// a small ring keeps producers and consumers contending on wraparound
+	ctx.q = r_mpmc_queue_new (64);
+	ctx.seen = calloc (1, TOTAL);
+	mu_assert ("stress setup", ctx.q && ctx.seen);
+	for (i = 0; i < PRODUCERS + CONSUMERS; i++) {
+		w[i].ctx = &ctx;
+		w[i].id = i < PRODUCERS? i: i - PRODUCERS;
+		th[i] = r_th_new (i < PRODUCERS? producer: consumer, &w[i], 0);
+		mu_assert ("thread creation", th[i] != NULL);
+	}
+	for (i = 0; i < PRODUCERS + CONSUMERS; i++) {
+		r_th_wait (th[i]);
+		r_th_free (th[i]);
+	}
+	for (i = 0; i < TOTAL; i++) {
+		if (!ctx.seen[i]) {
+			lost++;
+		}
+	}
+	mu_assert_eq (ctx.produced, TOTAL, "produced items");
+	mu_assert_eq (ctx.consumed, TOTAL, "consumed items");
+	mu_assert_eq (lost, 0, "lost items");
+	mu_assert_eq (ctx.duplicated, 0, "duplicated items");
+	mu_assert_eq (ctx.reordered, 0, "per-producer order");
+	mu_assert ("queue drained", r_mpmc_queue_is_empty (ctx.q));
+	free (ctx.seen);
+	r_mpmc_queue_free (ctx.q);
+	mu_end;
+}
+
+typedef struct {
+	RSpscQueue *q;
+	int errors;
+} SpscCtx;
+
+static int spsc_producer(RThread *th) {
+	SpscCtx *ctx = th->user;
+	int i;
+	for (i = 0; i < TOTAL; i++) {
+		while (!r_spsc_queue_push (ctx->q, ITEM (0, i))) {
+			r_sys_usleep (0);
+		}
+	}
+	return 0;
+}
+
+bool test_r_spsc_queue_stress(void) {
+	SpscCtx ctx = { 0 };
+	void *item;
+	int i;
+
+	ctx.q = r_spsc_queue_new (1024);
+	mu_assert ("spsc queue allocation", ctx.q != NULL);
+	RThread *th = r_th_new (spsc_producer, &ctx, 0);
+	mu_assert ("thread creation", th != NULL);
+	for (i = 0; i < TOTAL; i++) {
+		while (!r_spsc_queue_pop (ctx.q, &item)) {
+			r_sys_usleep (0);
+		}
+		if (ITEM_SEQ (item) != i) {
+			ctx.errors++;
+		}
+	}
+	r_th_wait (th);
+	r_th_free (th);
+	mu_assert_eq (ctx.errors, 0, "spsc items in order without loss");
+	mu_assert ("spsc queue drained", !r_spsc_queue_pop (ctx.q, &item));
+	r_spsc_queue_free (ctx.q);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_mpmc_queue_bounded);
+	mu_run_test(test_r_mpmc_queue_zero_size);
+	mu_run_test(test_r_mpmc_queue_stress);
+	mu_run_test(test_r_spsc_queue_stress);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -0,0 +1,197 @@
+#include <r_parse.h>
+#include "minunit.h"
+
+#define OUTSZ 1024
+
+typedef struct {
+	const char *plugin;
+	const char **ops;
+	const char **mnemonics;
+	const char **operands;
+} Corpus;
+
+static const char *x86_ops[] = {
+	"mov rbp, rsp", "xor ebp, ebp", "push rbp", "pop rbp", "add eax, 1",
+	"sub rsp, 0x10", "lea rax, [rip + 0x200]", "cmp eax, ebx", "jmp 0x400",
+	"call 0x401010", "ret", "mov dword [rbp - 4], 0", "inc ecx", "dec ecx",
+	"shl eax, 2", "imul eax, ecx", "test eax, eax", "and eax, 0xff",
+	"or eax, ebx", "nop", "int 0x80", "movzx eax, byte [rdi]", "",
+	"je 0x8048332", "call dword [0x402008]", "lea rax, str._twide_r_n", NULL
+};
+static const char *x86_mnem[] = { "mov", "add", "sub", "xor", "and", "or", "cmp", "test", "lea", "shl", "shr", "imul", "push", "pop", "inc", "dec", "jmp", "je", "jne", "call", NULL };
+static const char *x86_opnd[] = { "eax", "ebx", "ecx", "rsp", "rbp", "rdi", "0x10", "1", "-4", "dword [rbp - 8]", "qword [rip + 0x2000]", "byte [rdi]", "0x8048320", NULL };
+
+static const char *mips_ops[] = {
+	"move fp, sp", "sw fp, (sp)", "lw ra, 0x1c(sp)", "addiu sp, sp, -0x20",
+	"jr ra", "lui gp, 0x42", "addu v0, v0, v1", "beqz v0, 0x400100",
+	"jal 0x400200", "li a0, 1", "nop", "sll v0, v1, 2", "", NULL
+};
+static const char *mips_mnem[] = { "move", "sw", "lw", "addiu", "addu", "subu", "lui", "li", "beqz", "bnez", "jal", "jr", "sll", "srl", "and", "or", NULL };
+static const char *mips_opnd[] = { "v0", "v1", "a0", "sp", "fp", "ra", "gp", "0x1c(sp)", "(sp)", "-0x20", "0x42", "0x400100", NULL };
+
+static const char *arm_ops[] = {
+	"mov r0, r1", "add r0, r0, 1", "ldr r3, [r11, -8]", "str r3, [sp]",
+	"push {r4, lr}", "pop {r4, pc}", "bl 0x8000", "cmp r0, 0",
+	"sub sp, sp, 8", "bx lr", "", NULL
+};
+static const char *arm_mnem[] = { "mov", "add", "sub", "ldr", "str", "ldrb", "strb", "cmp", "b", "bl", "bx", "and", "orr", "eor", "lsl", NULL };
+static const char *arm_opnd[] = { "r0", "r1", "r3", "r11", "sp", "lr", "pc", "0", "8", "[sp]", "[r11, -8]", "0x8000", NULL };
+
+static const char *att_ops[] = {
+	"movl $3, %eax", "pushl %ebp", "movl %esp, %ebp", "addl $0x10, %esp",
+	"leal 4(%esp), %ecx", "call 0x8048320", "ret", "", NULL
+};
+static const char *att_mnem[] = { "movl", "addl", "subl", "pushl", "popl", "leal", "xorl", "cmpl", "call", "jmp", NULL };
+static const char *att_opnd[] = { "%eax", "%ebx", "%esp", "%ebp", "$3", "$0x10", "4(%esp)", "-8(%ebp)", "0x8048320", NULL };
+
+static const char *ppc_ops[] = {
+	"li r3, 0", "mr r31, r1", "stw r0, 8(r1)", "addi r1, r1, 16", "blr",
+	"lwz r0, 4(r1)", "", NULL
+};
+static const char *ppc_mnem[] = { "li", "mr", "stw", "lwz", "addi", "add", "subf", "cmpwi", "bl", "blr", "mtlr", "mflr", NULL };
+static const char *ppc_opnd[] = { "r0", "r1", "r3", "r31", "0", "16", "8(r1)", "4(r1)", "0x10000", NULL };
+
+static Corpus corpora[] = {
+	{ "x86.pseudo", x86_ops, x86_mnem, x86_opnd },
+	{ "mips.pseudo", mips_ops, mips_mnem, mips_opnd },
+	{ "arm.pseudo", arm_ops, arm_mnem, arm_opnd },
+	{ "att2intel", att_ops, att_mnem, att_opnd },
+	{ "ppc.pseudo", ppc_ops, ppc_mnem, ppc_opnd },
+};
+#define NCORPORA (sizeof (corpora) / sizeof (corpora[0]))
+
+static int count(const char **list) {
+	int n = 0;
+	while (list[n]) {
+		n++;
+	}
+	return n;
+}
+
+// Instructions made of random mnemonics and up to three operands
+static char **random_ops(Corpus *c, int n) {
+	char **ops = malloc (n * sizeof (char *));
+	int nm = count (c->mnemonics), no = count (c->operands);
+	int i, j;
+	for (i = 0; i < n; i++) {
+		char buf[256];
+		int args = rand () % 4;
+		int len = snprintf (buf, sizeof (buf), "%s", c->mnemonics[rand () % nm]);
+		for (j = 0; j < args; j++) {
+			len += snprintf (buf + len, sizeof (buf) - len, "%s%s",
+				j? ", ": " ", c->operands[rand () % no]);
+		}
+		ops[i] = strdup (buf);
+	}
+	return ops;
+}
+
+// Translates one instruction at a time like pd did, then the whole array
+// at once, and counts the instructions where both disagree
+static int compare_batch(RParse *p, const char **ops, int n) {
+	char **out = calloc (n, sizeof (char *));
+	char *str = malloc (OUTSZ);
+	int i, ok = 0, bad = 0;
+	for (i = 0; i < n; i++) {
+		*str = 0;
+		if (r_parse_parse (p, ops[i], str)) {
+			ok++;
+		}
+		out[i] = strdup (str);
+	}
+	char **batch = calloc (n, sizeof (char *));
+	int bok = r_parse_parse_batch (p, ops, batch, n);
+	if (bok != ok) {
+		eprintf ("%d translated one by one, %d in batch\n", ok, bok);
+		bad++;
+	}
+	for (i = 0; i < n; i++) {
+		if (!batch[i] || strcmp (out[i], batch[i])) {
+			eprintf ("'%s': '%s' one by one, '%s' in batch\n", ops[i], out[i], batch[i]);
+			bad++;
+		}
+		free (out[i]);
+		free (batch[i]);
+	}
+	free (out);
+	free (batch);
+	free (str);
+	return bad;
+}
+
+bool test_r_parse_att2intel(void) {
+	// from legacy_unit/parse/parse.c
+	char str[OUTSZ];
+	RParse *p = r_parse_new ();
+	mu_assert ("att2intel plugin", r_parse_use (p, "att2intel"));
+	mu_assert ("att to intel", r_parse_parse (p, "movl $3, %eax", str));
+	const char *ops[] = { "movl $3, %eax" };
+	char *out[1] = { NULL };
+	mu_assert_eq (r_parse_parse_batch (p, ops, out, 1), 1, "one translated in batch");
+	mu_assert_streq (out[0], str, "att to intel in batch");
+	free (out[0]);
+	mu_assert_eq (r_parse_parse_batch (p, ops, out, 0), 0, "empty batch");
+	r_parse_free (p);
+	mu_end;
+}
+
+bool test_r_parse_batch_known(void) {
+	RParse *p = r_parse_new ();
+	int i, bad = 0;
+	for (i = 0; i < NCORPORA; i++) {
+		mu_assert (corpora[i].plugin, r_parse_use (p, corpora[i].plugin));
+		bad += compare_batch (p, corpora[i].ops, count (corpora[i].ops));
+	}
+	mu_assert_eq (bad, 0, "batch matches one by one on known instructions");
+
+	// the expectations of t/cmd_pd and t.asm/mips/mips-pseudo
+	const char *x86[] = { "mov rbp, rsp", "xor ebp, ebp" };
+	const char *mips[] = { "move fp, sp", "sw fp, (sp)" };
+	char *out[2] = { NULL };
+	r_parse_use (p, "x86.pseudo");
+	r_parse_parse_batch (p, x86, out, 2);
+	mu_assert_streq (out[0], "rbp = rsp", "x86 move");
+	mu_assert_streq (out[1], "ebp = 0", "x86 xor with itself");
+	free (out[0]);
+	free (out[1]);
+	r_parse_use (p, "mips.pseudo");
+	r_parse_parse_batch (p, mips, out, 2);
+	mu_assert_streq (out[0], "fp = sp", "mips move");
+	mu_assert_streq (out[1], "[sp + 0] = fp", "mips store");
+	free (out[0]);
+	free (out[1]);
+	r_parse_free (p);
+	mu_end;
+}
+
+bool test_r_parse_batch_random(void) {
+	RParse *p = r_parse_new ();
+	int i, j, k, n = 20000, bad = 0;
+	srand (1337);
+	// switch plugins between batches so cached tables must follow
+	for (j = 0; j < 3; j++) {
+		for (i = 0; i < NCORPORA; i++) {
+			char **ops = random_ops (&corpora[i], n);
+			r_parse_use (p, corpora[i].plugin);
+			bad += compare_batch (p, (const char **)ops, n);
+			for (k = 0; k < n; k++) {
+				free (ops[k]);
+			}
+			free (ops);
+		}
+	}
+	mu_assert_eq (bad, 0, "batch matches one by one on random instructions");
+	r_parse_free (p);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_parse_att2intel);
+	mu_run_test(test_r_parse_batch_known);
+	mu_run_test(test_r_parse_batch_random);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
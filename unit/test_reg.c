@@ -0,0 +1,221 @@
+#include <r_reg.h>
+#include "minunit.h"
+
+// x86 profile from legacy_unit/reg/regdiff.c, the 10 byte st registers
+// straddle 16 byte boundaries which the block diff has to map back
+static const char *reg_profile =
+	"gpr eax .32 0 0\n"
+	"gpr ecx .32 4 0\n"
+	"gpr edx .32 8 0\n"
+	"gpr ebx .32 12 0\n"
+	"gpr esp .32 16 0\n"
+	"gpr ebp .32 20 0\n"
+	"gpr esi .32 24 0\n"
+	"gpr edi .32 28 0\n"
+	"gpr eip .32 32 0\n"
+	"gpr eflags .32 36 0\n"
+	"seg cs .32 40 0\n"
+	"seg ss .32 44 0\n"
+	"seg ds .32 48 0\n"
+	"seg es .32 52 0\n"
+	"seg fs .32 56 0\n"
+	"seg gs .32 60 0\n"
+	"gpr st0 .80 64 0\n"
+	"gpr st1 .80 74 0\n"
+	"gpr st2 .80 84 0\n"
+	"gpr st3 .80 94 0\n"
+	"gpr st4 .80 104 0\n"
+	"gpr st5 .80 114 0\n"
+	"gpr st6 .80 124 0\n"
+	"gpr st7 .80 134 0\n"
+	"gpr fctrl .32 144 0\n"
+	"gpr fstat .32 148 0\n"
+	"gpr ftag .32 152 0\n"
+	"gpr fiseg .32 156 0\n"
+	"gpr fioff .32 160 0\n"
+	"gpr foseg .32 164 0\n"
+	"gpr fooff .32 168 0\n"
+	"gpr fop .32 172 0\n"
+	"gpr xmm0 .128 176 0\n"
+	"gpr xmm1 .128 192 0\n"
+	"gpr xmm2 .128 208 0\n"
+	"gpr xmm3 .128 224 0\n"
+	"gpr xmm4 .128 240 0\n"
+	"gpr xmm5 .128 256 0\n"
+	"gpr xmm6 .128 272 0\n"
+	"gpr xmm7 .128 288 0\n"
+	"gpr mxcsr .32 304 0\n";
+
+#define ARENA_SIZE 308
+#define MAX_REGS 64
+
+static RReg *new_reg(void) {
+	RReg *reg = r_reg_new ();
+	r_reg_set_profile_string (reg, reg_profile);
+	return reg;
+}
+
+// Registers whose bytes differ from buf, in profile order
+static int diff_reference(RReg *reg, int type, const ut8 *buf, const char **names) {
+	RRegArena *arena = reg->regset[type].arena;
+	RListIter *iter;
+	RRegItem *ri;
+	int n = 0;
+	r_list_foreach (reg->regset[type].regs, iter, ri) {
+		int off = ri->offset / 8;
+		if (memcmp (arena->bytes + off, buf + off, (ri->size + 7) / 8)) {
+			names[n++] = ri->name;
+		}
+	}
+	return n;
+}
+
+static int diff_arena(RReg *reg, int type, const ut8 *buf, int len, const char **names) {
+	RList *changed = r_reg_arena_diff (reg, type, buf, len);
+	RListIter *iter;
+	RRegItem *ri;
+	int n = 0;
+	r_list_foreach (changed, iter, ri) {
+		if (n < MAX_REGS) {
+			names[n] = ri->name;
+		}
+		n++;
+	}
+	r_list_free (changed);
+	return n;
+}
+
+bool test_r_reg_arena_size(void) {
+	int sz;
+	RReg *reg = new_reg ();
+	free (r_reg_get_bytes (reg, R_REG_TYPE_GPR, &sz));
+	mu_assert_eq (sz, ARENA_SIZE, "arena size");
+	r_reg_free (reg);
+	mu_end;
+}
+
+bool test_r_reg_next_diff(void) {
+	RReg *reg = new_reg ();
+	RReg *reg2 = new_reg ();
+	const ut8 *bytes = reg2->regset[R_REG_TYPE_GPR].arena->bytes;
+	r_reg_setv (reg2, "ecx", 0xdeadbeef);
+	RRegItem *ri = r_reg_next_diff (reg, R_REG_TYPE_GPR, bytes, ARENA_SIZE, NULL, 32);
+	mu_assert ("ecx differs", ri && !strcmp (ri->name, "ecx"));
+	ri = r_reg_next_diff (reg, R_REG_TYPE_GPR, bytes, ARENA_SIZE, ri, 32);
+	mu_assert ("only ecx differs", !ri);
+	r_reg_free (reg);
+	r_reg_free (reg2);
+	mu_end;
+}
+
+bool test_r_reg_arena_diff(void) {
+	const char *names[MAX_REGS];
+	RReg *reg = new_reg ();
+	RReg *reg2 = new_reg ();
+	ut8 *bytes = reg2->regset[R_REG_TYPE_GPR].arena->bytes;
+
+	mu_assert_eq (diff_arena (reg, R_REG_TYPE_GPR, bytes, ARENA_SIZE, names), 0, "equal arenas");
+	r_reg_setv (reg2, "ecx", 0xdeadbeef);
+	bytes[83] ^= 1;  // last byte of st1, which starts in the previous block
+	bytes[94] ^= 1;  // first byte of st3
+	bytes[271] ^= 1; // last byte of xmm5
+	bytes[307] ^= 1; // last byte of the arena, in the scalar tail
+	mu_assert_eq (diff_arena (reg, R_REG_TYPE_GPR, bytes, ARENA_SIZE, names), 5, "changed registers");
+	mu_assert_streq (names[0], "ecx", "ecx changed");
+	mu_assert_streq (names[1], "st1", "st1 changed");
+	mu_assert_streq (names[2], "st3", "st3 changed");
+	mu_assert_streq (names[3], "xmm5", "xmm5 changed");
+	mu_assert_streq (names[4], "mxcsr", "mxcsr changed");
+
+	// eax sits at offset zero and must not be skipped
+	r_reg_setv (reg2, "eax", 1);
+	mu_assert_eq (diff_arena (reg, R_REG_TYPE_GPR, bytes, ARENA_SIZE, names), 6, "eax changed");
+	mu_assert_streq (names[0], "eax", "eax comes first");
+	r_reg_free (reg);
+	r_reg_free (reg2);
+	mu_end;
+}
+
+bool test_r_reg_arena_diff_random(void) {
+	const char *ref[MAX_REGS], *got[MAX_REGS];
+	RReg *reg = new_reg ();
+	RReg *reg2 = new_reg ();
+	ut8 *a = reg->regset[R_REG_TYPE_GPR].arena->bytes;
+	ut8 *b = reg2->regset[R_REG_TYPE_GPR].arena->bytes;
+	int i, j, bad = 0;
+
+	srand (1337);
+	for (i = 0; i < 100000; i++) {
+		int flips = 1 + rand () % 4;
+		memcpy (b, a, ARENA_SIZE);
+		for (j = 0; j < flips; j++) {
+			b[rand () % ARENA_SIZE] ^= 1 + rand () % 255;
+		}
+		int nref = diff_reference (reg, R_REG_TYPE_GPR, b, ref);
+		int ngot = diff_arena (reg, R_REG_TYPE_GPR, b, ARENA_SIZE, got);
+		if (nref != ngot) {
+			bad++;
+			continue;
+		}
+		for (j = 0; j < nref; j++) {
+			if (strcmp (ref[j], got[j])) {
+				bad++;
+				break;
+			}
+		}
+		// keep the base arena changing too
+		a[rand () % ARENA_SIZE] = rand ();
+	}
+	mu_assert_eq (bad, 0, "arena diff matches a per register compare");
+	r_reg_free (reg);
+	r_reg_free (reg2);
+	mu_end;
+}
+
+bool test_r_reg_arena_ring(void) {
+	RReg *reg = new_reg ();
+	int i, step[100];
+	mu_assert ("ring allocation", r_reg_arena_ring (reg, 8));
+	for (i = 0; i < 100; i++) {
+		r_reg_setv (reg, "eip", 0x8048000 + i);
+		r_reg_setv (reg, "ecx", i * 3);
+		step[i] = r_reg_arena_save (reg);
+	}
+	// the last eight steps are still in the ring, in any order
+	for (i = 99; i >= 92; i--) {
+		mu_assert ("load a snapshot in the ring", r_reg_arena_load (reg, step[i]));
+		mu_assert_eq ((int)r_reg_getv (reg, "eip"), 0x8048000 + i, "restored eip");
+		mu_assert_eq ((int)r_reg_getv (reg, "ecx"), i * 3, "restored ecx");
+	}
+	mu_assert ("overwritten snapshot", !r_reg_arena_load (reg, step[91]));
+	mu_assert_eq ((int)r_reg_getv (reg, "eip"), 0x8048000 + 92, "failed load keeps the arena");
+
+	// diff the current arena against a snapshot
+	const char *names[MAX_REGS];
+	const ut8 *saved = r_reg_arena_saved (reg, R_REG_TYPE_GPR, step[99]);
+	mu_assert ("saved arena bytes", saved != NULL);
+	mu_assert_eq (diff_arena (reg, R_REG_TYPE_GPR, saved, ARENA_SIZE, names), 2, "registers changed since step 99");
+	mu_assert_streq (names[0], "ecx", "ecx changed");
+	mu_assert_streq (names[1], "eip", "eip changed");
+
+	// the push/pop stack keeps working next to the ring
+	r_reg_arena_push (reg);
+	r_reg_setv (reg, "eip", 0);
+	r_reg_arena_pop (reg);
+	mu_assert_eq ((int)r_reg_getv (reg, "eip"), 0x8048000 + 92, "arena pop");
+	r_reg_free (reg);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_reg_arena_size);
+	mu_run_test(test_r_reg_next_diff);
+	mu_run_test(test_r_reg_arena_diff);
+	mu_run_test(test_r_reg_arena_diff_random);
+	mu_run_test(test_r_reg_arena_ring);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
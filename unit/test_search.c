@@ -0,0 +1,316 @@
+#include <r_util.h>
+#include <r_search.h>
+#include "minunit.h"
+
+#define MAX_HITS 200000
+
+typedef struct {
+	int kwidx;
+	ut64 addr;
+} Hit;
+
+typedef struct {
+	Hit *hits;
+	int n;
+} HitList;
+
+typedef struct {
+	const ut8 *kw;
+	const ut8 *bm;
+	int len;
+} KwSpec;
+
+static int collect(RSearchKeyword *kw, void *user, ut64 addr) {
+	HitList *hl = user;
+	if (hl->n < MAX_HITS) {
+		hl->hits[hl->n].kwidx = kw->kwidx;
+		hl->hits[hl->n].addr = addr;
+	}
+	hl->n++;
+	return 1;
+}
+
+// Runs one search feeding the buffer in chunks of the given size so that
+// matches straddling two r_search_update_i calls are exercised as well.
+static int run_search(int engine, KwSpec *kws, int nkws, const ut8 *buf, int len,
+		int chunk, int distance, bool overlap, HitList *hl) {
+	RSearch *rs = r_search_new (R_SEARCH_KEYWORD);
+	int i;
+	hl->n = 0;
+	if (!r_search_set_engine (rs, engine)) {
+		r_search_free (rs);
+		return -1;
+	}
+	for (i = 0; i < nkws; i++) {
+		r_search_kw_add (rs, r_search_keyword_new (kws[i].kw, kws[i].len,
+			kws[i].bm, kws[i].bm? kws[i].len: 0, NULL));
+	}
+	r_search_set_callback (rs, collect, hl);
+	r_search_set_distance (rs, distance);
+	rs->overlap = overlap;
+	r_search_begin (rs);
+	for (i = 0; i < len; i += chunk) {
+		r_search_update_i (rs, 0x1000 + i, buf + i, R_MIN (chunk, len - i));
+	}
+	r_search_free (rs);
+	return hl->n;
+}
+
+static bool same_hits(HitList *a, HitList *b) {
+	return a->n == b->n && !memcmp (a->hits, b->hits, sizeof (Hit) * R_MIN (a->n, MAX_HITS));
+}
+
+bool test_r_search_known(void) {
+	const char *buffer = "helloworldlibisnlizbiceandcoolib2loblubljb";
+	const int lib[] = { 10, 29 };
+	const int lxb[] = { 10, 29, 33, 36, 39 };
+	KwSpec kw = { (const ut8 *)"lib", NULL, 3 };
+	HitList hl = { calloc (MAX_HITS, sizeof (Hit)), 0 };
+	HitList dist = { calloc (MAX_HITS, sizeof (Hit)), 0 };
+	int engine, i, found, len = strlen (buffer);
+
+	for (engine = R_SEARCH_ENGINE_SCAN; engine <= R_SEARCH_ENGINE_AHO; engine++) {
+		kw.bm = NULL;
+		run_search (engine, &kw, 1, (const ut8 *)buffer, len, len, 0, false, &hl);
+		mu_assert_eq (hl.n, 2, "hits of 'lib'");
+		for (i = 0; i < hl.n; i++) {
+			mu_assert_eq ((int)hl.hits[i].addr, 0x1000 + lib[i], "address of 'lib'");
+		}
+		// distance 4 from the legacy test: the exact hits are still found
+		kw.bm = NULL;
+		run_search (engine, &kw, 1, (const ut8 *)buffer, len, len, 4, false, &hl);
+		mu_assert ("hits of 'lib' with distance 4", hl.n >= 2);
+		found = 0;
+		for (i = 0; i < hl.n; i++) {
+			found += hl.hits[i].addr == 0x1000 + lib[0] || hl.hits[i].addr == 0x1000 + lib[1];
+		}
+		mu_assert_eq (found, 2, "exact hits of 'lib' with distance 4");
+		if (engine == R_SEARCH_ENGINE_SCAN) {
+			memcpy (dist.hits, hl.hits, sizeof (Hit) * R_MIN (hl.n, MAX_HITS));
+			dist.n = hl.n;
+		} else {
+			mu_assert ("distance 4 hits identical to the scan engine", same_hits (&dist, &hl));
+		}
+		// the binmask ignores the middle byte so 'lob', 'lub' and 'ljb' match too
+		kw.bm = (const ut8 *)"\xff\x00\xff";
+		run_search (engine, &kw, 1, (const ut8 *)buffer, len, 1, 0, false, &hl);
+		mu_assert_eq (hl.n, 5, "hits of 'l?b'");
+		for (i = 0; i < hl.n; i++) {
+			mu_assert_eq ((int)hl.hits[i].addr, 0x1000 + lxb[i], "address of 'l?b'");
+		}
+	}
+	free (hl.hits);
+	free (dist.hits);
+	mu_end;
+}
+
+// A small alphabet keeps hits frequent and keywords sharing prefixes and
+// suffixes, which is where the failure links of the automaton matter.
+static ut8 *random_corpus(int len) {
+	static const ut8 alphabet[] = { 0x00, 0x01, 0xff, 'A', 'B', 'C', 'D', 0x90 };
+	ut8 *buf = malloc (len);
+	int i;
+	for (i = 0; i < len; i++) {
+		buf[i] = alphabet[rand () % sizeof (alphabet)];
+	}
+	return buf;
+}
+
+static KwSpec *random_keywords(const ut8 *buf, int len, int n, int minlen, bool masks) {
+	static const ut8 maskbytes[] = { 0xff, 0xff, 0xff, 0x00, 0xf0, 0x0f };
+	KwSpec *kws = calloc (n, sizeof (KwSpec));
+	int i, j;
+	for (i = 0; i < n; i++) {
+		int kwlen = minlen + rand () % (17 - minlen);
+		// most keywords are taken from the corpus so that they do hit
+		if (rand () % 4) {
+			kws[i].kw = buf + rand () % (len - kwlen);
+		} else {
+			ut8 *k = malloc (kwlen);
+			for (j = 0; j < kwlen; j++) {
+				k[j] = rand ();
+			}
+			kws[i].kw = k;
+		}
+		kws[i].len = kwlen;
+		if (masks && !(rand () % 3)) {
+			ut8 *m = malloc (kwlen);
+			for (j = 0; j < kwlen; j++) {
+				m[j] = maskbytes[rand () % sizeof (maskbytes)];
+			}
+			kws[i].bm = m;
+		}
+	}
+	return kws;
+}
+
+static void free_keywords(KwSpec *kws, int n, const ut8 *buf, int len) {
+	int i;
+	for (i = 0; i < n; i++) {
+		if (kws[i].kw < buf || kws[i].kw >= buf + len) {
+			free ((void *)kws[i].kw);
+		}
+		free ((void *)kws[i].bm);
+	}
+	free (kws);
+}
+
+bool test_r_search_engines_random(void) {
+	const int nkws[] = { 1, 2, 16, 100, 1000 };
+	const int chunks[] = { 1, 7, 4096, 0x40000 };
+	const int len = 0x40000;
+	HitList scan = { calloc (MAX_HITS, sizeof (Hit)), 0 };
+	HitList aho = { calloc (MAX_HITS, sizeof (Hit)), 0 };
+	int i, j;
+
+	srand (1337);
+	ut8 *buf = random_corpus (len);
+	for (i = 0; i < sizeof (nkws) / sizeof (nkws[0]); i++) {
+		// short keywords hit everywhere, keep them out of the large sets
+		KwSpec *kws = random_keywords (buf, len, nkws[i], nkws[i] > 16? 4: 1, true);
+		for (j = 0; j < sizeof (chunks) / sizeof (chunks[0]); j++) {
+			int chunk = chunks[j];
+			bool overlap = j & 1;
+			// byte by byte feeding is slow with many keywords, keep it for the small sets
+			if (chunk == 1 && nkws[i] > 16) {
+				continue;
+			}
+			run_search (R_SEARCH_ENGINE_SCAN, kws, nkws[i], buf, len, chunk, 0, overlap, &scan);
+			run_search (R_SEARCH_ENGINE_AHO, kws, nkws[i], buf, len, chunk, 0, overlap, &aho);
+			mu_assert ("scan engine finds hits", scan.n > 0);
+			mu_assert_eq (aho.n, scan.n, "number of hits");
+			mu_assert ("hits identical to the scan engine", same_hits (&scan, &aho));
+		}
+		free_keywords (kws, nkws[i], buf, len);
+	}
+	free (buf);
+	free (scan.hits);
+	free (aho.hits);
+	mu_end;
+}
+
+bool test_r_search_engines_distance(void) {
+	const int len = 0x8000;
+	HitList scan = { calloc (MAX_HITS, sizeof (Hit)), 0 };
+	HitList aho = { calloc (MAX_HITS, sizeof (Hit)), 0 };
+	int distance;
+
+	srand (31337);
+	ut8 *buf = random_corpus (len);
+	// keywords not longer than the distance match everywhere, keep them longer
+	KwSpec *kws = random_keywords (buf, len, 64, 6, true);
+	for (distance = 1; distance <= 3; distance++) {
+		run_search (R_SEARCH_ENGINE_SCAN, kws, 64, buf, len, 4096, distance, false, &scan);
+		run_search (R_SEARCH_ENGINE_AHO, kws, 64, buf, len, 4096, distance, false, &aho);
+		mu_assert_eq (aho.n, scan.n, "number of hits with distance");
+		mu_assert ("hits with distance identical to the scan engine", same_hits (&scan, &aho));
+	}
+	free_keywords (kws, 64, buf, len);
+	free (buf);
+	free (scan.hits);
+	free (aho.hits);
+	mu_end;
+}
+
+// Leftmost non-overlapping matches of the regex engine run over the whole
+// buffer, which is what regexp mode reported before the literal prefilter.
+static void regexp_reference(const char *pattern, bool icase, const ut8 *buf, int len, HitList *hl) {
+	RRegex *rx = r_regex_new (pattern, icase? "ei": "e");
+	RRegexMatch m = { 0, len };
+	hl->n = 0;
+	while (m.rm_so < len && !r_regex_exec (rx, (const char *)buf, 1, &m, R_REGEX_STARTEND)) {
+		if (hl->n < MAX_HITS) {
+			hl->hits[hl->n].kwidx = 0;
+			hl->hits[hl->n].addr = 0x1000 + m.rm_so;
+		}
+		hl->n++;
+		m.rm_so = R_MAX (m.rm_eo, m.rm_so + 1);
+		m.rm_eo = len;
+	}
+	r_regex_free (rx);
+}
+
+static void regexp_search(const char *pattern, bool icase, const ut8 *buf, int len, HitList *hl) {
+	RSearch *rs = r_search_new (R_SEARCH_REGEXP);
+	hl->n = 0;
+	r_search_kw_add (rs, r_search_keyword_new_str (pattern, icase? "i": "", NULL, 0));
+	r_search_set_callback (rs, collect, hl);
+	r_search_begin (rs);
+	r_search_update_i (rs, 0x1000, buf, len);
+	r_search_free (rs);
+}
+
+bool test_r_search_regexp_known(void) {
+	const char *buffer = "ELF,e,e,e,ELF--fooo";
+	HitList hl = { calloc (MAX_HITS, sizeof (Hit)), 0 };
+	regexp_search ("E.F", true, (const ut8 *)buffer, strlen (buffer), &hl);
+	mu_assert_eq (hl.n, 2, "hits of /E.F/i");
+	mu_assert_eq ((int)hl.hits[0].addr, 0x1000, "first ELF");
+	mu_assert_eq ((int)hl.hits[1].addr, 0x100a, "second ELF");
+	regexp_search ("E.F", false, (const ut8 *)buffer, strlen (buffer), &hl);
+	mu_assert_eq (hl.n, 2, "hits of /E.F/");
+	regexp_search ("e.e", false, (const ut8 *)buffer, strlen (buffer), &hl);
+	mu_assert_eq (hl.n, 1, "matches do not overlap");
+	free (hl.hits);
+	mu_end;
+}
+
+bool test_r_search_regexp_prefilter(void) {
+	static const char *words[] = {
+		"lib", "libc.so.6", "ELF", "GLIBC_2.2.5", "foo", "bar", "baz", "0x8048000",
+		"main", "/usr/lib/", "Elf", "x86", " ", " ", "\n", ".", "\x7f"
+	};
+	// patterns with a required prefix, infix or suffix literal and some
+	// without any, where the prefilter has to fall back to a full scan
+	static const char *patterns[] = {
+		"lib[a-z]*[.]so", "GLIBC_[0-9.]+", "E.F", "(foo|bar)+baz", "0x[0-9a-f]+",
+		"ba[rz]", "usr/lib/", "[A-Z]{3}", "[0-9]+", "f(o)+", "(main|libc)", "x86|ELF",
+		"[.]so[.][0-9]", "[^ ]+lib/"
+	};
+	const int len = 0x40000;
+	HitList ref = { calloc (MAX_HITS, sizeof (Hit)), 0 };
+	HitList got = { calloc (MAX_HITS, sizeof (Hit)), 0 };
+	ut8 *buf = malloc (len);
+	int i, off = 0;
+
+	srand (4242);
+	while (off < len) {
+		const char *w = words[rand () % (sizeof (words) / sizeof (words[0]))];
+		int wl = R_MIN ((int)strlen (w), len - off);
+		memcpy (buf + off, w, wl);
+		off += wl;
+	}
+	for (i = 0; i < sizeof (patterns) / sizeof (patterns[0]); i++) {
+		int icase;
+		for (icase = 0; icase < 2; icase++) {
+			regexp_reference (patterns[i], icase, buf, len, &ref);
+			regexp_search (patterns[i], icase, buf, len, &got);
+			mu_assert ("regexp finds hits", ref.n > 0);
+			mu_assert_eq (got.n, ref.n, "number of regexp hits");
+			int j, bad = 0;
+			for (j = 0; j < R_MIN (ref.n, MAX_HITS); j++) {
+				if (got.hits[j].addr != ref.hits[j].addr) {
+					bad++;
+				}
+			}
+			mu_assert_eq (bad, 0, "regexp hits identical to the regex engine");
+		}
+	}
+	free (buf);
+	free (ref.hits);
+	free (got.hits);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_search_known);
+	mu_run_test(test_r_search_engines_random);
+	mu_run_test(test_r_search_engines_distance);
+	mu_run_test(test_r_search_regexp_known);
+	mu_run_test(test_r_search_regexp_prefilter);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -0,0 +1,230 @@
+#include <r_socket.h>
+#include <r_th.h>
+#include <sys/resource.h>
+#include "minunit.h"
+
+#define CLIENT_THREADS 10
+#define MAX_CLIENTS 1000
+#define ROUNDS 20
+
+typedef struct {
+	RSocketLoop *loop;
+	char port[16];
+	int lines;
+	int peak;
+} ServerCtx;
+
+// Replies "pong <id> <seq>" to "ping <id> <seq>" and echoes anything else
+static bool echo_line(RSocketLoop *loop, RSocketConn *conn, const char *line, void *user) {
+	ServerCtx *ctx = user;
+	char reply[32 * 1024];
+	__sync_fetch_and_add (&ctx->lines, 1);
+	int open = r_socket_loop_count (loop);
+	if (open > ctx->peak) {
+		ctx->peak = open;
+	}
+	if (!strcmp (line, "quit")) {
+		return false;
+	}
+	if (!strncmp (line, "ping ", 5)) {
+		snprintf (reply, sizeof (reply), "pong %s\n", line + 5);
+	} else {
+		snprintf (reply, sizeof (reply), "%s\n", line);
+	}
+	return r_socket_loop_write (conn, reply, strlen (reply));
+}
+
+static int server_thread(RThread *th) {
+	ServerCtx *ctx = th->user;
+	r_socket_loop_run (ctx->loop);
+	return 0;
+}
+
+// Listens on a free loopback port and serves it from a thread
+static RThread *server_start(ServerCtx *ctx, RSocket **listener) {
+	int i;
+	RSocket *s = r_socket_new (false);
+	s->local = true;
+	for (i = 0; i < 100; i++) {
+		snprintf (ctx->port, sizeof (ctx->port), "%d", 20000 + (int)((r_sys_now () + i * 7919) % 30000));
+		if (r_socket_listen (s, ctx->port, NULL)) {
+			break;
+		}
+	}
+	if (i == 100) {
+		r_socket_free (s);
+		return NULL;
+	}
+	*listener = s;
+	ctx->loop = r_socket_loop_new (s, echo_line, ctx);
+	return r_th_new (server_thread, ctx, 0);
+}
+
+static void server_stop(ServerCtx *ctx, RThread *th, RSocket *listener) {
+	r_socket_loop_stop (ctx->loop);
+	r_th_wait (th);
+	r_th_free (th);
+	r_socket_loop_free (ctx->loop);
+	r_socket_free (listener);
+}
+
+static RSocket *client_connect(ServerCtx *ctx) {
+	RSocket *c = r_socket_new (false);
+	if (!r_socket_connect_tcp (c, "127.0.0.1", ctx->port, 10)) {
+		r_socket_free (c);
+		return NULL;
+	}
+	return c;
+}
+
+bool test_r_socket_loop_lines(void) {
+	ServerCtx ctx = { 0 };
+	RSocket *listener = NULL;
+	char buf[32 * 1024];
+	RThread *th = server_start (&ctx, &listener);
+	mu_assert ("loopback server", th != NULL);
+	RSocket *c = client_connect (&ctx);
+	mu_assert ("client connection", c != NULL);
+
+	// a line split over several writes is delivered once, complete
+	r_socket_puts (c, "hel");
+	r_sys_usleep (10000);
+	r_socket_puts (c, "lo wor");
+	r_sys_usleep (10000);
+	r_socket_puts (c, "ld\n");
+	r_socket_gets (c, buf, sizeof (buf));
+	mu_assert_streq (buf, "hello world", "line split over writes");
+
+	// several lines in one write are answered in order
+	r_socket_puts (c, "ping 1 1\nping 1 2\nping 1 3\n");
+	r_socket_gets (c, buf, sizeof (buf));
+	mu_assert_streq (buf, "pong 1 1", "first pipelined line");
+	r_socket_gets (c, buf, sizeof (buf));
+	mu_assert_streq (buf, "pong 1 2", "second pipelined line");
+	r_socket_gets (c, buf, sizeof (buf));
+	mu_assert_streq (buf, "pong 1 3", "third pipelined line");
+
+	// a line longer than the socket buffers
+	char *longline = malloc (20000 + 2);
+	memset (longline, 'A', 20000);
+	strcpy (longline + 20000, "\n");
+	r_socket_write (c, longline, 20001);
+	int len = 0;
+	while (len < 20000) {
+		int r = r_socket_gets (c, buf + len, sizeof (buf) - len);
+		if (r <= 0) {
+			break;
+		}
+		len += r;
+	}
+	mu_assert_eq (len, 20000, "long line echoed");
+	mu_assert ("long line contents", buf[0] == 'A' && buf[19999] == 'A');
+	free (longline);
+
+	r_socket_puts (c, "quit\n");
+	r_socket_free (c);
+	server_stop (&ctx, th, listener);
+	mu_end;
+}
+
+typedef struct {
+	ServerCtx *server;
+	int first, count;
+	int *ready;
+	int errors;
+} ClientCtx;
+
+static int client_thread(RThread *th) {
+	ClientCtx *cc = th->user;
+	RSocket *socks[MAX_CLIENTS];
+	char line[64], buf[64];
+	int i, round;
+
+	for (i = 0; i < cc->count; i++) {
+		socks[i] = client_connect (cc->server);
+		if (!socks[i]) {
+			cc->errors++;
+		}
+	}
+	// wait until every client of every thread is connected
+	__sync_fetch_and_add (cc->ready, 1);
+	while (*cc->ready < CLIENT_THREADS) {
+		r_sys_usleep (1000);
+	}
+	for (round = 0; round < ROUNDS; round++) {
+		for (i = 0; i < cc->count; i++) {
+			if (socks[i]) {
+				snprintf (line, sizeof (line), "ping %d %d\n", cc->first + i, round);
+				r_socket_puts (socks[i], line);
+			}
+		}
+		for (i = 0; i < cc->count; i++) {
+			if (!socks[i]) {
+				continue;
+			}
+			snprintf (line, sizeof (line), "pong %d %d", cc->first + i, round);
+			if (r_socket_gets (socks[i], buf, sizeof (buf)) <= 0 || strcmp (buf, line)) {
+				cc->errors++;
+			}
+		}
+	}
+	for (i = 0; i < cc->count; i++) {
+		r_socket_free (socks[i]);
+	}
+	return 0;
+}
+
+bool test_r_socket_loop_concurrent(void) {
+	ServerCtx ctx = { 0 };
+	ClientCtx cc[CLIENT_THREADS];
+	RThread *clients[CLIENT_THREADS];
+	RSocket *listener = NULL;
+	struct rlimit rl;
+	int i, ready = 0, errors = 0;
+
+	// both ends of every connection live in this process
+	getrlimit (RLIMIT_NOFILE, &rl);
+	rl.rlim_cur = rl.rlim_max;
+	setrlimit (RLIMIT_NOFILE, &rl);
+	getrlimit (RLIMIT_NOFILE, &rl);
+	if (rl.rlim_cur < MAX_CLIENTS * 2 + 64) {
+		eprintf ("open files limited to %d, %d are needed\n", (int)rl.rlim_cur, MAX_CLIENTS * 2 + 64);
+	}
+	mu_assert ("open files for every client", rl.rlim_cur >= MAX_CLIENTS * 2 + 64);
+
+	RThread *th = server_start (&ctx, &listener);
+	mu_assert ("loopback server", th != NULL);
+	for (i = 0; i < CLIENT_THREADS; i++) {
+		cc[i].server = &ctx;
+		cc[i].count = MAX_CLIENTS / CLIENT_THREADS;
+		cc[i].first = i * cc[i].count;
+		cc[i].ready = &ready;
+		cc[i].errors = 0;
+		clients[i] = r_th_new (client_thread, &cc[i], 0);
+	}
+	for (i = 0; i < CLIENT_THREADS; i++) {
+		r_th_wait (clients[i]);
+		r_th_free (clients[i]);
+		errors += cc[i].errors;
+	}
+	mu_assert_eq (errors, 0, "every client got its own replies in order");
+	mu_assert_eq (ctx.lines, MAX_CLIENTS * ROUNDS, "lines served");
+	mu_assert_eq (ctx.peak, MAX_CLIENTS, "clients connected at once");
+	// closed clients are dropped from the loop
+	for (i = 0; i < 100 && r_socket_loop_count (ctx.loop) > 0; i++) {
+		r_sys_usleep (10000);
+	}
+	mu_assert_eq (r_socket_loop_count (ctx.loop), 0, "closed connections released");
+	server_stop (&ctx, th, listener);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_socket_loop_lines);
+	mu_run_test(test_r_socket_loop_concurrent);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -0,0 +1,152 @@
+#include <r_syscall.h>
+#include "minunit.h"
+
+#define SYSCALL_SUBDIR "/share/radare2/" R2_VERSION "/syscall"
+
+typedef struct {
+	RSyscall *sc;
+	int defswi;
+	int entries;
+	int names;
+	int bad;
+} CheckCtx;
+
+// Every key of the table goes through the public lookups, which must
+// answer exactly what the raw sdb lookup answers
+static int check_entry(void *user, const char *k, const char *v) {
+	CheckCtx *ctx = user;
+	Sdb *db = ctx->sc->db;
+	unsigned int swi;
+	int num, len = 0;
+	if (sscanf (k, "0x%x.%d%n", &swi, &num, &len) == 2 && !k[len]) {
+		// "0x80.4=write"
+		const char *name = r_syscall_get_i (ctx->sc, num, swi);
+		if (!name || strcmp (name, v)) {
+			eprintf ("%s: get_i gives %s, sdb has %s\n", k, name, v);
+			ctx->bad++;
+		}
+		if ((int)swi == ctx->defswi) {
+			name = r_syscall_get_i (ctx->sc, num, -1);
+			if (!name || strcmp (name, v)) {
+				eprintf ("%s: get_i with the default swi gives %s\n", k, name);
+				ctx->bad++;
+			}
+		}
+		RSyscallItem *si = r_syscall_get (ctx->sc, num, swi);
+		if (!si || strcmp (si->name, v) || si->num != num
+				|| si->args != (int)sdb_array_get_num (db, v, 2, NULL)) {
+			eprintf ("%s: get gives a different item\n", k);
+			ctx->bad++;
+		}
+		r_syscall_item_free (si);
+		ctx->entries++;
+	} else if (*k != '_' && strchr (v, ',')) {
+		// "write=0x80,4,3,"
+		int ref = (int)sdb_array_get_num (db, k, 1, NULL);
+		if (r_syscall_get_num (ctx->sc, k) != ref) {
+			eprintf ("%s: get_num gives %d, sdb has %d\n", k,
+				r_syscall_get_num (ctx->sc, k), ref);
+			ctx->bad++;
+		}
+		ctx->names++;
+	}
+	return 1;
+}
+
+// The tables live where r_syscall_setup loads them from: under the
+// prefix of the installed r2, which may differ from the one we were
+// built against, and under the libdir on older trees
+static RList *syscall_files(void) {
+	char *dirs[3] = { NULL };
+	char *prefix = r_sys_cmd_str ("r2 -H R2_PREFIX", NULL, NULL);
+	RList *files = NULL;
+	int i;
+	if (prefix && *prefix) {
+		char *nl = strchr (prefix, '\n');
+		if (nl) {
+			*nl = 0;
+		}
+		dirs[0] = r_str_newf ("%s" SYSCALL_SUBDIR, prefix);
+	}
+	dirs[1] = strdup (R2_PREFIX SYSCALL_SUBDIR);
+	dirs[2] = strdup (R2_LIBDIR "/radare2/" R2_VERSION "/syscall");
+	for (i = 0; i < 3; i++) {
+		if (!files && dirs[i]) {
+			files = r_sys_dir (dirs[i]);
+			if (files && r_list_length (files) < 1) {
+				r_list_free (files);
+				files = NULL;
+			}
+		}
+		free (dirs[i]);
+	}
+	free (prefix);
+	return files;
+}
+
+bool test_r_syscall_hello(void) {
+	// from legacy_unit/syscall/hello.c
+	RSyscall *sc = r_syscall_new ();
+	mu_assert ("linux x86 32 table", r_syscall_setup (sc, "x86", "linux", 32));
+	mu_assert_streq (r_syscall_get_i (sc, 4, -1), "write", "syscall 4");
+	mu_assert_eq (r_syscall_get_num (sc, "write"), 4, "write number");
+	mu_assert ("unknown number", !r_syscall_get_i (sc, 100000, -1));
+	const char *arg1 = r_syscall_reg (sc, 1, 3);
+	const char *arg2 = r_syscall_reg (sc, 2, 3);
+	const char *arg3 = r_syscall_reg (sc, 3, 3);
+	mu_assert ("registers of a 3 argument syscall", arg1 && arg2 && arg3);
+	mu_assert ("distinct argument registers",
+		strcmp (arg1, arg2) && strcmp (arg2, arg3) && strcmp (arg1, arg3));
+
+	// switching tables drops the lookups of the previous one
+	mu_assert ("linux x86 64 table", r_syscall_setup (sc, "x86", "linux", 64));
+	mu_assert_eq (r_syscall_get_num (sc, "write"), 1, "write number on x86-64");
+	mu_assert ("unknown table", !r_syscall_setup (sc, "x86", "no_such_os", 32));
+	r_syscall_free (sc);
+	mu_end;
+}
+
+bool test_r_syscall_all_tables(void) {
+	RList *files = syscall_files ();
+	RListIter *iter;
+	char *file, os[32], arch[32];
+	int bits, tables = 0, bad = 0;
+
+	mu_assert ("syscall tables installed", files && r_list_length (files) > 0);
+	r_list_foreach (files, iter, file) {
+		if (!r_str_endswith (file, ".sdb")
+				|| sscanf (file, "%31[^-]-%31[^-]-%d.sdb", os, arch, &bits) != 3) {
+			continue;
+		}
+		CheckCtx ctx = { 0 };
+		ctx.sc = r_syscall_new ();
+		if (!r_syscall_setup (ctx.sc, arch, os, bits)) {
+			eprintf ("%s: setup failed\n", file);
+			bad++;
+			r_syscall_free (ctx.sc);
+			continue;
+		}
+		ctx.defswi = (int)sdb_num_get (ctx.sc->db, "_", NULL);
+		sdb_foreach (ctx.sc->db, check_entry, &ctx);
+		if (ctx.bad || !ctx.entries || !ctx.names) {
+			eprintf ("%s: %d of %d entries differ\n", file, ctx.bad, ctx.entries + ctx.names);
+			bad++;
+		}
+		r_syscall_free (ctx.sc);
+		tables++;
+	}
+	r_list_free (files);
+	mu_assert ("tables checked", tables > 0);
+	mu_assert_eq (bad, 0, "every table matches its sdb");
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_syscall_hello);
+	mu_run_test(test_r_syscall_all_tables);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -0,0 +1,184 @@
+#include <r_util.h>
+#include <r_th.h>
+#include "minunit.h"
+
+static void *square(RThread *th, void *user) {
+	intptr_t n = (intptr_t)user;
+	return (void *)(n * n);
+}
+
+bool test_r_th_pool_submit(void) {
+	RThreadFuture *fut[1000];
+	RThreadPool *pool = r_th_pool_new (4);
+	intptr_t i;
+	mu_assert ("pool allocation", pool != NULL);
+	for (i = 0; i < 1000; i++) {
+		fut[i] = r_th_pool_submit (pool, square, (void *)i);
+		mu_assert ("submit", fut[i] != NULL);
+	}
+	for (i = 0; i < 1000; i++) {
+		intptr_t r = (intptr_t)r_th_future_wait (fut[i]);
+		mu_assert_eq ((int)r, (int)(i * i), "future result");
+		r_th_future_free (fut[i]);
+	}
+	r_th_pool_free (pool);
+	mu_end;
+}
+
+typedef struct {
+	RThreadPool *pool;
+	int n;
+} FibArgs;
+
+// Waiting on a future from inside a worker must run other tasks instead
+// of blocking, otherwise a fork/join tree deadlocks once every worker waits.
+static void *fib(RThread *th, void *user) {
+	FibArgs *a = user;
+	if (a->n < 2) {
+		return (void *)(intptr_t)a->n;
+	}
+	FibArgs left = { a->pool, a->n - 1 };
+	FibArgs right = { a->pool, a->n - 2 };
+	RThreadFuture *f = r_th_pool_submit (a->pool, fib, &left);
+	intptr_t r = (intptr_t)fib (th, &right);
+	r += (intptr_t)r_th_future_wait (f);
+	r_th_future_free (f);
+	return (void *)r;
+}
+
+bool test_r_th_pool_fork_join(void) {
+	int workers[] = { 1, 2, 64 };
+	int i;
+	for (i = 0; i < 3; i++) {
+		RThreadPool *pool = r_th_pool_new (workers[i]);
+		FibArgs args = { pool, 22 };
+		RThreadFuture *f = r_th_pool_submit (pool, fib, &args);
+		mu_assert_eq ((int)(intptr_t)r_th_future_wait (f), 17711, "fib(22)");
+		r_th_future_free (f);
+		r_th_pool_free (pool);
+	}
+	mu_end;
+}
+
+#define RANGE_FROM 0x8048000ULL
+#define RANGE_SIZE 0x100000
+
+typedef struct {
+	ut8 *hits;
+	int calls;
+} RangeCtx;
+
+static bool mark_range(RThread *th, void *user, ut64 from, ut64 to) {
+	RangeCtx *ctx = user;
+	ut64 a;
+	for (a = from; a < to; a++) {
+		__sync_fetch_and_add (&ctx->hits[a - RANGE_FROM], 1);
+	}
+	__sync_fetch_and_add (&ctx->calls, 1);
+	return true;
+}
+
+bool test_r_th_pool_parallel_for(void) {
+	// more workers than cores and a chunk size that does not divide the range
+	RThreadPool *pool = r_th_pool_new (r_th_pool_ncpus () * 4);
+	RangeCtx ctx = { 0 };
+	int i, bad = 0;
+	ctx.hits = calloc (1, RANGE_SIZE);
+	bool ok = r_th_pool_parallel_for (pool, RANGE_FROM, RANGE_FROM + RANGE_SIZE,
+		0x1234, mark_range, &ctx);
+	mu_assert ("parallel_for completes", ok);
+	for (i = 0; i < RANGE_SIZE; i++) {
+		if (ctx.hits[i] != 1) {
+			bad++;
+		}
+	}
+	mu_assert_eq (bad, 0, "every address visited exactly once");
+	mu_assert_eq (ctx.calls, (RANGE_SIZE + 0x1233) / 0x1234, "chunk count");
+
+	// an empty range must not call the kernel
+	ctx.calls = 0;
+	ok = r_th_pool_parallel_for (pool, RANGE_FROM, RANGE_FROM, 0x1000, mark_range, &ctx);
+	mu_assert ("empty parallel_for", ok);
+	mu_assert_eq (ctx.calls, 0, "empty range calls");
+	free (ctx.hits);
+	r_th_pool_free (pool);
+	mu_end;
+}
+
+static void *spin_until_break(RThread *th, void *user) {
+	int *started = user;
+	__sync_fetch_and_add (started, 1);
+	while (!th->breaked) {
+		r_sys_usleep (100);
+	}
+	return (void *)1;
+}
+
+typedef struct {
+	RThreadPool *pool;
+	int started;
+} CancelCtx;
+
+static bool spin_range(RThread *th, void *user, ut64 from, ut64 to) {
+	CancelCtx *ctx = user;
+	__sync_fetch_and_add (&ctx->started, 1);
+	while (!th->breaked) {
+		r_sys_usleep (100);
+	}
+	return false;
+}
+
+static int cancel_pool(RThread *th) {
+	CancelCtx *ctx = th->user;
+	while (!ctx->started) {
+		r_sys_usleep (100);
+	}
+	r_th_pool_cancel (ctx->pool);
+	return 0;
+}
+
+bool test_r_th_pool_cancel(void) {
+	RThreadPool *pool = r_th_pool_new (4);
+	RThreadFuture *fut[16];
+	int i, started = 0;
+	for (i = 0; i < 16; i++) {
+		fut[i] = r_th_pool_submit (pool, spin_until_break, &started);
+	}
+	while (started < 4) {
+		r_sys_usleep (100);
+	}
+	r_th_pool_cancel (pool);
+	for (i = 0; i < 16; i++) {
+		// running tasks observe th->breaked, queued ones are dropped
+		void *r = r_th_future_wait (fut[i]);
+		mu_assert ("cancelled future", r == (void *)1 || r_th_future_cancelled (fut[i]));
+		r_th_future_free (fut[i]);
+	}
+
+	// the pool is usable again after a cancellation
+	RThreadFuture *f = r_th_pool_submit (pool, square, (void *)7);
+	mu_assert_eq ((int)(intptr_t)r_th_future_wait (f), 49, "pool reuse");
+	r_th_future_free (f);
+
+	// cancelling a parallel_for from another thread makes it return false
+	CancelCtx cctx = { pool, 0 };
+	RThread *canceller = r_th_new (cancel_pool, &cctx, 0);
+	bool ok = r_th_pool_parallel_for (pool, 0, 0x10000, 0x100, spin_range, &cctx);
+	mu_assert ("cancelled parallel_for", !ok);
+	r_th_wait (canceller);
+	r_th_free (canceller);
+	r_th_pool_free (pool);
+	mu_end;
+}
+
+int all_tests() {
+	mu_run_test(test_r_th_pool_submit);
+	mu_run_test(test_r_th_pool_fork_join);
+	mu_run_test(test_r_th_pool_parallel_for);
+	mu_run_test(test_r_th_pool_cancel);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
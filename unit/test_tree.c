@@ -100,8 +100,150 @@ bool test_r_tree() {
 	mu_end;
 }
 
+bool test_r_tree_postorder() {
+	RTreeVisitor lister = { 0 };
+	RTree *t = r_tree_new();
+
+	RTreeNode *root = r_tree_add_node(t, NULL, (void *)1);
+	r_tree_add_node(t, root, (void *)2);
+	RTreeNode *s = r_tree_add_node(t, root, (void *)3);
+	RTreeNode *u = r_tree_add_node(t, root, (void *)4);
+	r_tree_add_node(t, s, (void *)5);
+	r_tree_add_node(t, s, (void *)10);
+	r_tree_add_node(t, u, (void *)11);
+
+	RList *exp = r_list_new();
+	r_list_append(exp, (void *)2);
+	r_list_append(exp, (void *)5);
+	r_list_append(exp, (void *)10);
+	r_list_append(exp, (void *)3);
+	r_list_append(exp, (void *)11);
+	r_list_append(exp, (void *)4);
+	r_list_append(exp, (void *)1);
+	lister.post_visit = (RTreeNodeVisitCb)add_to_list;
+	lister.data = r_list_new();
+	r_tree_dfs(t, &lister);
+	check_list((RList *)lister.data, exp, "lister.postorder");
+	r_list_free(exp);
+	r_list_free((RList *)lister.data);
+
+	r_tree_free(t);
+	mu_end;
+}
+
+/* the traversal must not recurse, or a long chain blows the stack */
+#define DEEP_NODES 1000000
+#define WIDE_NODES 1000000
+
+typedef struct {
+	int count;
+	int last;
+	bool ordered;
+} OrderCheck;
+
+void check_ascending(RTreeNode *n, RTreeVisitor *vis) {
+	OrderCheck *oc = (OrderCheck *)vis->data;
+	int cur = (int)(intptr_t)n->data;
+	if (oc->count && cur != oc->last + 1) {
+		oc->ordered = false;
+	}
+	oc->last = cur;
+	oc->count++;
+}
+
+void check_descending(RTreeNode *n, RTreeVisitor *vis) {
+	OrderCheck *oc = (OrderCheck *)vis->data;
+	int cur = (int)(intptr_t)n->data;
+	if (oc->count && cur != oc->last - 1) {
+		oc->ordered = false;
+	}
+	oc->last = cur;
+	oc->count++;
+}
+
+bool test_r_tree_deep() {
+	RTreeVisitor vis = { 0 };
+	OrderCheck oc;
+	RTree *t = r_tree_new();
+	RTreeNode *n = NULL;
+	int i;
+
+	for (i = 0; i < DEEP_NODES; i++) {
+		n = r_tree_add_node(t, n, (void *)(intptr_t)i);
+		mu_assert("add_node on a deep chain", n != NULL);
+	}
+
+	vis.data = &oc;
+	vis.pre_visit = (RTreeNodeVisitCb)check_ascending;
+	memset(&oc, 0, sizeof (oc));
+	oc.ordered = true;
+	r_tree_bfs(t, &vis);
+	mu_assert_eq(oc.count, DEEP_NODES, "deep.bfs count");
+	mu_assert("deep.bfs order", oc.ordered);
+
+	memset(&oc, 0, sizeof (oc));
+	oc.ordered = true;
+	r_tree_dfs(t, &vis);
+	mu_assert_eq(oc.count, DEEP_NODES, "deep.preorder count");
+	mu_assert("deep.preorder order", oc.ordered);
+
+	vis.pre_visit = NULL;
+	vis.post_visit = (RTreeNodeVisitCb)check_descending;
+	memset(&oc, 0, sizeof (oc));
+	oc.ordered = true;
+	r_tree_dfs(t, &vis);
+	mu_assert_eq(oc.count, DEEP_NODES, "deep.postorder count");
+	mu_assert_eq(oc.last, 0, "deep.postorder ends at root");
+	mu_assert("deep.postorder order", oc.ordered);
+
+	r_tree_free(t);
+	mu_end;
+}
+
+bool test_r_tree_wide() {
+	RTreeVisitor vis = { 0 };
+	OrderCheck oc;
+	RTree *t = r_tree_new();
+	RTreeNode *root = r_tree_add_node(t, NULL, (void *)0);
+	int i;
+
+	for (i = 1; i < WIDE_NODES; i++) {
+		mu_assert("add_node on a wide tree",
+			r_tree_add_node(t, root, (void *)(intptr_t)i) != NULL);
+	}
+
+	vis.data = &oc;
+	vis.pre_visit = (RTreeNodeVisitCb)check_ascending;
+	memset(&oc, 0, sizeof (oc));
+	oc.ordered = true;
+	r_tree_bfs(t, &vis);
+	mu_assert_eq(oc.count, WIDE_NODES, "wide.bfs count");
+	mu_assert("wide.bfs order", oc.ordered);
+
+	memset(&oc, 0, sizeof (oc));
+	oc.ordered = true;
+	r_tree_dfs(t, &vis);
+	mu_assert_eq(oc.count, WIDE_NODES, "wide.preorder count");
+	mu_assert("wide.preorder order", oc.ordered);
+
+	/* reset must drop every node at once and leave the tree reusable */
+	r_tree_reset(t);
+	mu_assert("reset.root", t->root == NULL);
+	root = r_tree_add_node(t, NULL, (void *)42);
+	vis.pre_visit = (RTreeNodeVisitCb)sum_node;
+	vis.data = (void *)0;
+	r_tree_bfs(t, &vis);
+	mu_assert_eq((int)(intptr_t)vis.data, 42, "reset.reuse");
+
+	r_tree_free(t);
+	mu_end;
+}
+
 int all_tests() {
 	mu_run_test(test_r_tree);
+	mu_run_test(test_r_tree_postorder);
+	mu_run_test(test_r_tree_deep);
+	mu_run_test(test_r_tree_wide);
 	return tests_passed != tests_run;
 }
 